@@ -0,0 +1,83 @@
+#define F_CPU 1000000UL
+#include "adc.h"
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+
+// Prescaler 8: F_ADC = 125 kHz com F_CPU = 1 MHz (faixa tima 50-200 kHz)
+#define ADC_PRESCALER  ((1 << ADPS1) | (1 << ADPS0))
+#define ADC_CONV_US    (13UL * 8 * 1000000UL / F_CPU)   // 13 ciclos do ADC
+
+static volatile uint8_t adc_done;
+static uint8_t last_ref = ADC_REF_AVCC;  // referncia da ltima leitura (AREF)
+
+ISR(ADC_vect) {
+	adc_done = 1;
+}
+
+void adc_init(void) {
+	ADMUX = ADC_REF_AVCC;
+	ADCSRA = 0;                          // desligado at a primeira leitura
+	DIDR0 = (1 << LM35_CHANNEL);         // sem buffer digital no pino analgico
+}
+
+// Uma converso: entrar em SLEEP_MODE_ADC com o ADC ligado j dispara
+// a converso; outras interrupes (TWI, WDT) podem acordar antes, ento
+// dorme de novo at a ISR do ADC marcar o fim.
+static uint16_t convert(void) {
+	set_sleep_mode(SLEEP_MODE_ADC);
+	cli();
+	adc_done = 0;
+	while (!adc_done) {
+		sleep_enable();
+		sei();                           // sei + sleep: sem janela para perder a ISR
+		sleep_cpu();
+		sleep_disable();
+		cli();
+	}
+	sei();
+	return ADC;
+}
+
+uint16_t adc_read_os(uint8_t channel, uint8_t ref, uint8_t n) {
+	ADMUX = ref | (channel & 0x0F);
+	ADCSRA = (1 << ADEN) | (1 << ADIE) | ADC_PRESCALER;
+
+	// A primeira converso aps ligar o ADC ou trocar a referncia sai
+	// errada (capacitor do AREF ainda acomodando): descartada. Vindo de
+	// AVcc para 1.1 V o AREF leva ADC_REF_SETTLE_US para descer; a espera
+	//  feita convertendo e descartando, com a CPU dormindo em SLEEP_MODE_ADC.
+	uint16_t discard = 1;
+	if (ref == ADC_REF_1V1 && last_ref != ADC_REF_1V1)
+		discard = ADC_REF_SETTLE_US / ADC_CONV_US;
+	last_ref = ref;
+	while (discard--) convert();
+
+	uint32_t sum = 0;
+	for (uint16_t i = (uint16_t)1 << (2 * n); i; i--)
+		sum += convert();
+
+	ADCSRA = 0;                          // ADC desligado: no consome no power-down
+	return (uint16_t)(sum >> n);         // decimao: 10 + n bits
+}
+
+int16_t lm35_read_centi(void) {
+#if LM35_USE_1V1
+	const uint8_t ref = ADC_REF_1V1;
+	const uint32_t vref_mv = ADC_1V1_MV;
+#else
+	const uint8_t ref = ADC_REF_AVCC;
+	const uint32_t vref_mv = ADC_AVCC_MV;
+#endif
+	uint16_t r = adc_read_os(LM35_CHANNEL, ref, LM35_OVERSAMPLE);
+
+	// T[0.01 C] = r * Vref[mV] / 2^(10+n) / (10 mV/C) * 100
+	uint8_t bits = 10 + LM35_OVERSAMPLE;
+	return (int16_t)((r * vref_mv * 10 + ((uint32_t)1 << (bits - 1))) >> bits);
+}
+
+uint16_t adc_vcc_mv(void) {
+	// r = 1.1 V * 2^(10+n) / VCC  =>  VCC = 1.1 V * 2^(10+n) / r
+	uint16_t r = adc_read_os(ADC_CH_BANDGAP, ADC_REF_AVCC, 1);
+	if (r == 0) return 0xFFFF;
+	return (uint16_t)(((uint32_t)ADC_1V1_MV << 11) / r);
+}
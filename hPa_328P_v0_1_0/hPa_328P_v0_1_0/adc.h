@@ -0,0 +1,52 @@
+#ifndef ADC_H
+#define ADC_H
+#include <avr/io.h>
+#include <stdint.h>
+
+// Referncias do ADC (bits REFS1:0 do ADMUX)
+#define ADC_REF_AVCC   (1 << REFS0)
+#define ADC_REF_1V1    ((1 << REFS1) | (1 << REFS0))
+
+#define ADC_AVCC_MV    5000    // AVcc nominal
+#define ADC_1V1_MV     1100    // bandgap nominal (1.0 .. 1.2 V entre chips)
+
+// Descida do AREF de AVcc para 1.1 V: o capacitor do pino (100 nF) s
+// descarrega pela sada fraca da referncia interna (~32 kohm, tau ~3.2 ms);
+// chegar a meio LSB de 12 bits leva ~9 tau. A subida para AVcc passa pela
+// chave do AVcc e cabe na converso descartada.
+#ifndef ADC_REF_SETTLE_US
+#define ADC_REF_SETTLE_US 30000UL
+#endif
+
+// Canal analgico do sensor LM35 (10 mV/C)
+#define LM35_CHANNEL   0       // PC0 / ADC0
+
+// 1 = LM35 contra a referncia interna de 1.1 V: ~0.11 C/LSB, at 110 C.
+// 0 = contra AVcc: ~0.49 C/LSB, at 150 C.
+#ifndef LM35_USE_1V1
+#define LM35_USE_1V1   1
+#endif
+
+// Sobreamostragem: 4^n converses somadas e decimadas em n bits extras
+// (o rudo natural do ADC, ~1 LSB, faz o papel do dither)
+#ifndef LM35_OVERSAMPLE
+#define LM35_OVERSAMPLE 2      // 16 converses, 12 bits efetivos (~1.7 ms)
+#endif
+
+void adc_init(void);
+
+// Uma leitura com 10 + n bits: 4^n converses em SLEEP_MODE_ADC (a CPU
+// dorme durante cada converso e acorda pelo ISR(ADC_vect)). O ADC s fica
+// ligado durante a chamada.
+uint16_t adc_read_os(uint8_t channel, uint8_t ref, uint8_t n);
+
+// Temperatura do LM35 em centsimos de C
+int16_t lm35_read_centi(void);
+
+// Tenso de alimentao em mV: mede o bandgap (1.1 V) contra AVcc, ento
+// no precisa de pino nem divisor. Preciso limitada pelo bandgap (10%
+// entre chips; ajuste ADC_1V1_MV com a tenso medida no AREF).
+#define ADC_CH_BANDGAP 0x0E    // MUX3:0 = 1110
+uint16_t adc_vcc_mv(void);
+
+#endif
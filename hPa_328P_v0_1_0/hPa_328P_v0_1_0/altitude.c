@@ -0,0 +1,38 @@
+#define F_CPU 1000000UL
+#include "altitude.h"
+#include <avr/pgmspace.h>
+
+// h(r) + ALT_OFFSET em dm para r = 0.625 + i/128, i = 0..64
+// (deslocado para caber em uint16: h vai de +37928 a -10048 dm)
+#define ALT_OFFSET 10048
+static const uint16_t alt_tab[ALTITUDE_RATIO_MAX_Q7 - ALTITUDE_RATIO_MIN_Q7 + 1] PROGMEM = {
+	47976, 47017, 46067, 45126, 44195, 43272, 42358, 41453,
+	40557, 39668, 38787, 37915, 37050, 36192, 35343, 34500,
+	33665, 32836, 32014, 31200, 30392, 29590, 28795, 28006,
+	27223, 26446, 25675, 24911, 24151, 23398, 22650, 21908,
+	21171, 20439, 19713, 18991, 18275, 17564, 16857, 16156,
+	15459, 14767, 14080, 13397, 12718, 12044, 11375, 10709,
+	10048, 9391, 8738, 8089, 7444, 6804, 6167, 5533,
+	4904, 4278, 3657, 3038, 2423, 1812, 1205, 600,
+	0,
+};
+
+int32_t altitude_dm(int32_t p_pa, int32_t p_ref_pa) {
+	if (p_pa <= 0 || p_ref_pa <= 0) return 0;
+
+	// r * 128 = ndice na tabela (parte inteira) + frao em Q15 (resto)
+	uint32_t x = ((uint32_t)p_pa << 7) / (uint32_t)p_ref_pa;
+	uint32_t rem = ((uint32_t)p_pa << 7) - x * (uint32_t)p_ref_pa;
+
+	if (x < ALTITUDE_RATIO_MIN_Q7)
+		return (int32_t)pgm_read_word(&alt_tab[0]) - ALT_OFFSET;
+	if (x >= ALTITUDE_RATIO_MAX_Q7)
+		return (int32_t)pgm_read_word(&alt_tab[ALTITUDE_RATIO_MAX_Q7 - ALTITUDE_RATIO_MIN_Q7]) - ALT_OFFSET;
+
+	uint8_t i = (uint8_t)(x - ALTITUDE_RATIO_MIN_Q7);
+	int32_t h0 = (int32_t)pgm_read_word(&alt_tab[i]) - ALT_OFFSET;
+	int16_t dh = (int16_t)(pgm_read_word(&alt_tab[i + 1]) - pgm_read_word(&alt_tab[i]));
+	int32_t f = (int32_t)((rem << 15) / (uint32_t)p_ref_pa);   // 0..32767
+
+	return h0 + (((int32_t)dh * f + 16384) >> 15);
+}
@@ -0,0 +1,20 @@
+#ifndef ALTITUDE_H
+#define ALTITUDE_H
+#include <stdint.h>
+
+// Altitude baromtrica relativa  presso de referncia, sem float/pow:
+//   h = 44330 * (1 - (p / p_ref)^0.1903)   [m]
+// Tabela de 65 pontos (passo 1/128 na razo p/p_ref) com interpolao linear.
+//
+// Faixa: p/p_ref em [0.625, 1.125], ou seja, ~ -1000 m a +3790 m em relao
+//  referncia; fora dela o resultado satura no extremo da tabela.
+// Erro contra a frmula em double (varredura no host, p_ref de 30000 a
+// 120000 Pa, todo p na faixa): at 2.1 dm; at 1.5 dm com p/p_ref em
+// [0.85, 1.125]. Abaixo do rudo do sensor (~2.5 dm no BMP180 em OSS 3).
+#define ALTITUDE_RATIO_MIN_Q7  80      // 0.625 * 128
+#define ALTITUDE_RATIO_MAX_Q7  144     // 1.125 * 128
+
+// Presso e referncia em Pa (p_ref at 131071); resultado em decmetros
+int32_t altitude_dm(int32_t p_pa, int32_t p_ref_pa);
+
+#endif
@@ -0,0 +1,121 @@
+#define F_CPU 1000000UL
+#include "baro.h"
+#include "bmp180.h"
+#include "bmp280.h"
+#include <avr/eeprom.h>
+#include <util/crc16.h>
+#include <util/delay.h>
+#include <string.h>
+
+static const baro_ops_t bmp180_ops = {
+	BMP180_ADDR, BARO_ID_BMP180, BMP180_CALIB_REG, BMP180_CALIB_LEN, bmp180_init_calib,
+	bmp180_start_temp, bmp180_poll, bmp180_wait_us, bmp180_result_raw, bmp180_set_oss
+};
+
+static const baro_ops_t bmp280_ops = {
+	BMP280_ADDR, BARO_ID_BMP280, BMP280_CALIB_REG, BMP280_CALIB_LEN, bmp280_init_calib,
+	bmp280_start, bmp280_poll, bmp280_wait_us, bmp280_result_raw, 0
+};
+
+static const baro_ops_t *const drivers[] = { &bmp180_ops, &bmp280_ops };
+
+static const baro_ops_t *ops;    // NULL at a deteco achar um sensor
+static uint8_t from_cache;
+
+// =======================================================
+// Cache da calibrao na EEPROM
+// =======================================================
+typedef struct {
+	uint8_t  id;                     // chip ID do sensor que gerou o cache
+	uint8_t  calib[BARO_CALIB_MAX];  // bytes brutos como esto no sensor
+	uint16_t crc;                    // CRC-16 de id + calib
+} baro_cache_t;
+
+static baro_cache_t EEMEM ee_cache;
+
+// Bytes conferidos no sensor antes de aceitar o cache: pega a troca por
+// outro sensor do mesmo modelo (o ID  igual, a calibrao no)
+#define BARO_FINGERPRINT 4
+
+static uint16_t cache_crc(const baro_cache_t *c) {
+	uint16_t crc = _crc16_update(0xFFFF, c->id);
+	for (uint8_t i = 0; i < BARO_CALIB_MAX; i++)
+		crc = _crc16_update(crc, c->calib[i]);
+	return crc;
+}
+
+// Procura o chip ID de cada driver no endereo dele; repete s se nenhum
+// sensor respondeu ainda
+static const baro_ops_t *detect(void) {
+	for (uint8_t i = 0; i < 5; i++) {
+		for (uint8_t k = 0; k < sizeof(drivers) / sizeof(drivers[0]); k++) {
+			uint8_t id = 0;
+			if (twi_read_regs(drivers[k]->addr, BARO_REG_ID, &id, 1) == TWI_OK &&
+			    id == drivers[k]->id)
+				return drivers[k];
+		}
+		_delay_ms(10);
+	}
+	return 0;
+}
+
+twi_status_t baro_init(void) {
+	_delay_ms(BARO_STARTUP_MS);      // start-up do datasheet; nada mais de espera
+
+	from_cache = 0;
+	if (!(ops = detect())) return TWI_NACK;
+	uint8_t id = ops->id;
+
+	baro_cache_t c;
+	uint8_t fp[BARO_FINGERPRINT];
+	twi_status_t st;
+	eeprom_read_block(&c, &ee_cache, sizeof(c));
+	if (c.id == id && c.crc == cache_crc(&c) &&
+	    twi_read_regs(ops->addr, ops->calib_reg, fp, sizeof(fp)) == TWI_OK &&
+	    memcmp(fp, c.calib, sizeof(fp)) == 0) {
+		st = ops->init_calib(c.calib);
+		from_cache = (st == TWI_OK);
+		if (from_cache) return st;
+	}
+
+	// Cache ausente, corrompido ou de outro sensor: l e regrava
+	memset(&c, 0, sizeof(c));
+	c.id = id;
+	if ((st = twi_read_regs(ops->addr, ops->calib_reg, c.calib, ops->calib_len)) != TWI_OK)
+		return st;
+	if ((st = ops->init_calib(c.calib)) != TWI_OK)
+		return st;                   // coeficientes invlidos no vo para o cache
+	c.crc = cache_crc(&c);
+	eeprom_update_block(&c, &ee_cache, sizeof(c));   // s grava bytes que mudaram
+	return TWI_OK;
+}
+
+uint8_t baro_from_cache(void) {
+	return from_cache;
+}
+
+twi_status_t baro_start(void) {
+	return ops ? ops->start() : TWI_NACK;
+}
+
+uint8_t baro_poll(void) {
+	return ops ? ops->poll() : 1;
+}
+
+uint16_t baro_wait_us(void) {
+	return ops ? ops->wait_us() : 0;
+}
+
+twi_status_t baro_read(int16_t *t_centi, int32_t *p_pa) {
+	return ops ? ops->read(t_centi, p_pa) : TWI_NACK;
+}
+
+twi_status_t baro_read_raw(int16_t *t_centi, int32_t *p_pa) {
+	baro_start();
+	while (!baro_poll());
+	return baro_read(t_centi, p_pa);
+}
+
+void baro_set_oss(uint8_t oss) {
+	if (ops && ops->set_oss) ops->set_oss(oss);
+}
@@ -0,0 +1,52 @@
+#ifndef BARO_H
+#define BARO_H
+#include <stdint.h>
+#include "twi_master.h"
+
+// Barmetro comum: BMP180 (sempre 0x77) e BMP280 (BMP280_ADDR, 0x76 ou
+// 0x77 pelo pino SDO) so diferenciados pelo chip ID (registrador 0xD0) lido
+// no endereo de cada um no boot, ento o mesmo firmware serve s duas
+// placas e cada uma usa o caminho nativo do seu sensor.
+#define BARO_REG_ID    0xD0
+#define BARO_ID_BMP180 0x55
+#define BARO_ID_BMP280 0x58
+
+// Operaes de cada driver (set_oss pode ser NULL)
+typedef struct {
+	uint8_t addr;                        // endereo I2C do driver (ID, calibrao)
+	uint8_t id;                          // chip ID esperado nesse endereo
+	uint8_t calib_reg;                   // calibrao: primeiro registrador
+	uint8_t calib_len;                   // e tamanho (<= BARO_CALIB_MAX)
+	twi_status_t (*init_calib)(const uint8_t *calib);
+	twi_status_t (*start)(void);
+	uint8_t      (*poll)(void);
+	uint16_t     (*wait_us)(void);
+	twi_status_t (*read)(int16_t *t_centi, int32_t *p_pa);
+	void         (*set_oss)(uint8_t oss);
+} baro_ops_t;
+
+// Maior start-up dos dois (BMP180: 10 ms, BMP280: 2 ms); o ID ainda no  conhecido
+#define BARO_STARTUP_MS 10
+#define BARO_CALIB_MAX  24
+
+// Detecta o sensor e inicializa o driver correspondente. A calibrao vem
+// do cache na EEPROM (chip ID + bytes brutos + CRC-16) quando o ID e os
+// primeiros bytes dos coeficientes conferem com o sensor presente; seno
+//  lida do sensor e o cache  regravado.
+twi_status_t baro_init(void);
+uint8_t baro_from_cache(void);       // 1 se o ltimo baro_init() usou o cache
+
+// Mesma semntica do driver: start dispara a medida, poll devolve 1 quando
+// terminou (ou houve erro) e read compensa (0.01 C, Pa) e informa o status.
+// wait_us  o pior caso at a etapa em andamento acabar (BMP180: UT e
+// depois UP), para dormir em vez de consultar o sensor em volta.
+twi_status_t baro_start(void);
+uint8_t baro_poll(void);
+uint16_t baro_wait_us(void);
+twi_status_t baro_read(int16_t *t_centi, int32_t *p_pa);
+twi_status_t baro_read_raw(int16_t *t_centi, int32_t *p_pa);   // bloqueante
+
+// Oversampling de presso (s BMP180; ignorado no BMP280)
+void baro_set_oss(uint8_t oss);
+
+#endif
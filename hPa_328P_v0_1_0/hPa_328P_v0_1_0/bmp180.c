@@ -1,77 +1,124 @@
 #define F_CPU 1000000UL      // Define clock do AVR como 1 MHz (para delay e timing interno)
 
 #include "bmp180.h"          // Header do driver do BMP180 (declaraes)
-#include "twi_master.h"      // Funes de IC (start, write, read, stop)
+#include "twi_master.h"      // Transaes IC (fila + ISR)
 #include <util/delay.h>      // Biblioteca de delays do AVR
-#include <math.h>            // Usado para clculos matemticos (float)
+#include <avr/pgmspace.h>    // Tabela de sementes do recproco na flash
+#include "prof.h"            // Marcador da compensao (PROFILE = 1)
 
 // Variveis globais de calibrao do BMP180 armazenadas aps bmp180_init()
 static int16_t  AC1, AC2, AC3, B1, B2, MB, MC, MD;
 static uint16_t AC4, AC5, AC6;
 static int32_t  b5;          // Valor intermedirio usado nos clculos
 
+// Constantes derivadas da calibrao (calculadas uma vez em bmp180_init)
+static int32_t  mc_11;       // MC * 2^11
+static int32_t  ac1_4;       // AC1 * 4
+
 // =======================================================
-// Funes bsicas de leitura e escrita IC (8 bits)
+// Diviso por recproco
+// O AVR no divide em hardware: __udivmodsi4/__divmodsi4 da libgcc fazem
+// a diviso em lao, um bit por passo. Aqui o quociente  estimado com um
+// recproco de 16 bits (semente + 2 passos de Newton) e acertado pelo
+// resto exato, ento o resultado  idntico ao operador '/' (verificado
+// no host, tests/test_bmp180_kernel.c). O ganho em ciclos ainda no foi
+// medido: a fase PROF_BMP180 do make -C host bench  onde medir.
 // =======================================================
 
-// L 1 byte de um registrador do BMP180
-static uint8_t r8(uint8_t reg) {
-	twi_start();             // START no barramento IC
-	twi_write(0xEE);         // Endereo do BMP180 em modo WRITE (0xEE)
-	twi_write(reg);          // Seleciona o registrador que queremos ler
-	twi_start();             // Repeated START
-	twi_write(0xEF);         // Endereo do BMP180 em modo READ (0xEF)
-	uint8_t v = twi_read_nack(); // L 1 byte, ltimo byte ? NACK
-	twi_stop();              // Encerra a comunicao
-	return v;                // Retorna o valor lido
-}
-
-// L 2 bytes consecutivos (MSB + LSB)
-static uint16_t r16(uint8_t reg) {
-	twi_start();             // START
-	twi_write(0xEE);         // Endereo WRITE
-	twi_write(reg);          // Registrador
-	twi_start();             // Repeated START
-	twi_write(0xEF);         // Endereo READ
-	uint16_t v = ((uint16_t)twi_read_ack() << 8) | twi_read_nack();
-	// L MSB com ACK e LSB com NACK
-	twi_stop();              // STOP
-	return v;                // Retorna o valor de 16 bits
+// floor(2^31 / d) no maior d de cada faixa de 1024 em [2^15, 2^16): a semente
+// nunca passa do recproco real e o Newton converge por baixo
+static const uint16_t recip_seed[32] PROGMEM = {
+	63551, 61682, 59920, 58255, 56681, 55189, 53774, 52430,
+	51151, 49933, 48772, 47663, 46604, 45591, 44621, 43691,
+	42799, 41943, 41121, 40330, 39569, 38836, 38130, 37449,
+	36792, 36158, 35545, 34953, 34380, 33825, 33288, 32768
+};
+
+typedef struct {
+	uint16_t d;              // divisor (>= RECIP_MIN)
+	uint16_t r;              // ~2^31 / (d << s), nunca maior que o valor real
+	uint8_t  s;              // normalizao: d << s fica em [2^15, 2^16)
+} recip_t;
+
+// Abaixo disso a estimativa erra demais e cai no '/' comum
+#define RECIP_MIN  256
+
+static void recip_set(recip_t *q, uint16_t d) {
+	uint8_t s = 0;
+	uint16_t n = d;
+	while (!(n & 0x8000)) { n <<= 1; s++; }
+
+	uint16_t r = pgm_read_word(&recip_seed[(n >> 10) & 0x1F]);
+	for (uint8_t i = 0; i < 2; i++) {
+		uint32_t e = 0x80000000UL - (uint32_t)n * r;     // >= 0, pois r <= 2^31/n
+		uint32_t nr = r + (((uint32_t)(uint16_t)(e >> 15) * r) >> 16);
+		r = nr > 0xFFFF ? 0xFFFF : (uint16_t)nr;         // satura s em n = 2^15
+	}
+	q->d = d;
+	q->r = r;
+	q->s = s;
 }
 
-// Escreve 1 byte em um registrador
-static void w8(uint8_t reg, uint8_t val) {
-	twi_start();             // START
-	twi_write(0xEE);         // Endereo WRITE
-	twi_write(reg);          // Escolhe registrador
-	twi_write(val);          // Escreve valor
-	twi_stop();              // STOP
+// floor(n / d) aproximado por baixo: duas multiplicaes 16x16
+static uint32_t recip_est(const recip_t *q, uint32_t n) {
+	uint32_t t = (uint32_t)(uint16_t)(n >> 16) * q->r
+	           + (((uint32_t)(uint16_t)n * q->r) >> 16);
+	return t >> (15 - q->s);
+}
+
+// n / d exato: estimativa, nova estimativa sobre o resto e no mximo
+// uma correo (verificado para todo d >= RECIP_MIN)
+static uint32_t recip_div(const recip_t *q, uint32_t n) {
+	uint32_t quo = recip_est(q, n);
+	uint32_t rem = n - quo * q->d;
+	uint32_t q2 = recip_est(q, rem);
+	quo += q2;
+	rem -= q2 * q->d;
+	while (rem >= q->d) { quo++; rem -= q->d; }
+	return quo;
 }
 
+// Diviso com sinal (truncada para zero, como o '/' do C)
+static int32_t sdiv(int32_t n, int32_t d) {
+	uint32_t ad = d < 0 ? -(uint32_t)d : (uint32_t)d;
+	if (ad < RECIP_MIN || ad > 0xFFFF) return n / d;
+	recip_t q;
+	recip_set(&q, (uint16_t)ad);
+	uint32_t a = recip_div(&q, n < 0 ? -(uint32_t)n : (uint32_t)n);
+	return ((n < 0) != (d < 0)) ? -(int32_t)a : (int32_t)a;
+}
+
+// Termos que s dependem de UT (e da calibrao): reaproveitados enquanto
+// a temperatura bruta no muda
+static uint8_t  k_valid;
+static uint16_t k_ut;
+static int32_t  k_b3x;       // AC1*4 + x3, antes do deslocamento pelo OSS
+static uint32_t k_b4;
+static recip_t  k_b4r;       // recproco de b4 (d = 0: b4 fora da faixa)
+
 // =======================================================
-// Inicializao e leitura da calibrao
+// Acesso a registradores (transaes em bloco com repeated START)
 // =======================================================
-void bmp180_init(void) {
-	_delay_ms(1000);         // Tempo para o BMP180 inicializar aps ligar
 
-	// Pequenas leituras para garantir que o sensor "acordou"
-	for(uint8_t i=0;i<5;i++) {
-		r8(0xD0);           // Registrador ID
-		_delay_ms(10);
-	}
+// Escreve 1 byte em um registrador
+static twi_status_t w8(uint8_t reg, uint8_t val) {
+	return twi_write_regs(BMP180_ADDR, reg, &val, 1);
+}
 
-	// Leitura em bloco dos 22 bytes de calibrao
-	twi_start();
-	twi_write(0xEE);         // Endereo WRITE
-	twi_write(0xAA);         // Endereo do primeiro registrador de calibrao
-	twi_start();
-	twi_write(0xEF);         // Endereo READ
-
-	uint8_t buf[22];         // Buffer dos 22 bytes
-	for (uint8_t i=0; i<21; i++)
-	buf[i] = twi_read_ack();
-	buf[21] = twi_read_nack(); // ltimo byte com NACK
-	twi_stop();
+// L n bytes a partir de reg numa nica transao
+static twi_status_t rd(uint8_t reg, uint8_t *buf, uint8_t n) {
+	return twi_read_regs(BMP180_ADDR, reg, buf, n);
+}
+
+static uint8_t calib_ok(void) {
+	return !(AC1 == 0 || AC1 == (int16_t)0xFFFF);
+}
+
+// =======================================================
+// Inicializao e leitura da calibrao
+// =======================================================
+twi_status_t bmp180_init_calib(const uint8_t *buf) {
+	twi_set_speed(BMP180_ADDR, BMP180_SPEED);
 
 	// Converte bytes para variveis reais do datasheet
 	AC1 = (int16_t)((buf[0]  << 8) | buf[1]);
@@ -85,61 +132,176 @@ void bmp180_init(void) {
 	MB  = (int16_t)((buf[16] << 8) | buf[17]);
 	MC  = (int16_t)((buf[18] << 8) | buf[19]);
 	MD  = (int16_t)((buf[20] << 8) | buf[21]);
+
+	mc_11 = (int32_t)MC * 2048;
+	ac1_4 = (int32_t)AC1 * 4;
+	k_valid = 0;
+	return calib_ok() ? TWI_OK : TWI_NACK;
+}
+
+twi_status_t bmp180_init(void) {
+	twi_set_speed(BMP180_ADDR, BMP180_SPEED);
+	_delay_ms(BMP180_STARTUP_MS);   // start-up do datasheet aps ligar
+
+	// Leitura em bloco dos 22 bytes de calibrao
+	uint8_t buf[BMP180_CALIB_LEN];  // Buffer dos 22 bytes (a partir de 0xAA)
+	twi_status_t st = rd(BMP180_CALIB_REG, buf, sizeof(buf)); // ltimo byte com NACK (na ISR)
+	if (st != TWI_OK)
+		return st;           // Calibrao fica zerada: bmp180_read() recusa ler
+	return bmp180_init_calib(buf);
 }
 
 // =======================================================
-// Leitura de temperatura e presso (OSS = 0)
+// Converso assncrona (OSS 0..3, ver bmp180_set_oss)
+// start_temp -> [Sco=0] l UT e dispara a presso -> [Sco=0] l UP -> pronto.
+// O bit Sco (bit 5 de 0xF4) fica em 1 enquanto a converso corre, ento
+// o tempo real do sensor  usado no lugar dos _delay_ms de pior caso.
 // =======================================================
-void bmp180_read(float *temperature, float *pressure) {
+#define BMP180_SCO     (1 << 5)
 
-	// Se calibrao invlida
-	if (AC1 == 0 || AC1 == 0xFFFF) {
-		*temperature = 0;
-		*pressure = 0;
-		return;
+#define ST_IDLE        0
+#define ST_TEMP        1   // convertendo temperatura
+#define ST_PRESS       2   // convertendo presso
+#define ST_READY       3   // UT e UP lidos (ou erro em last_st)
+
+static uint8_t  state = ST_IDLE;
+static twi_status_t last_st = TWI_OK;
+static uint16_t ut;          // temperatura bruta
+static uint32_t up;          // presso bruta
+static uint8_t  oss = BMP180_OSS_DEFAULT;  // oversampling da presso
+static uint16_t polls_left;  // consultas ao Sco antes de desistir
+
+// Tempo mximo de converso (datasheet, us): temperatura e presso OSS 0..3
+static const uint16_t conv_us[5] = { 4500, 4500, 7500, 13500, 25500 };
+
+// Uma consulta ao Sco = 4 bytes no barramento (SLA+W, reg, SLA+R, dado)
+#define BMP180_POLL_US  (4UL * 9000000UL / TWI_SCL_REAL(TWI_SCL_400K))
+
+// Limite de consultas: 2x o tempo mximo de converso, medido em consultas
+static void arm_polls(uint8_t idx) {
+	polls_left = (uint16_t)(2UL * conv_us[idx] / BMP180_POLL_US + 2);
+}
+
+void bmp180_set_oss(uint8_t o) {
+	oss = o > 3 ? 3 : o;
+}
+
+uint16_t bmp180_conv_us(uint8_t o) {
+	return conv_us[1 + (o > 3 ? 3 : o)];
+}
+
+// Quanto dormir antes do prximo bmp180_poll(): pior caso da etapa atual
+uint16_t bmp180_wait_us(void) {
+	if (state == ST_TEMP)  return conv_us[0];
+	if (state == ST_PRESS) return bmp180_conv_us(oss);
+	return 0;
+}
+
+// Falha de barramento: encerra a converso, resultado fica com o erro
+static uint8_t fail(twi_status_t st) {
+	last_st = st;
+	state = ST_READY;
+	return 1;
+}
+
+twi_status_t bmp180_start_temp(void) {
+	if (!calib_ok()) { last_st = TWI_NACK; state = ST_READY; return TWI_NACK; }
+	twi_status_t st = w8(0xF4, 0x2E);   // Comando de leitura de temperatura (~4.5 ms)
+	if (st != TWI_OK) { fail(st); return st; }
+	last_st = TWI_OK;
+	state = ST_TEMP;
+	arm_polls(0);
+	return TWI_OK;
+}
+
+twi_status_t bmp180_start_pressure(void) {
+	twi_status_t st = w8(0xF4, 0x34 + (oss << 6));  // Comando de presso (4.5 .. 25.5 ms)
+	if (st != TWI_OK) { fail(st); return st; }
+	state = ST_PRESS;
+	arm_polls(1 + oss);
+	return TWI_OK;
+}
+
+uint8_t bmp180_poll(void) {
+	if (state == ST_READY || state == ST_IDLE) return 1;
+
+	twi_status_t st;
+	uint8_t d[3];
+	if ((st = rd(0xF4, d, 1)) != TWI_OK) return fail(st);
+	if (d[0] & BMP180_SCO) {            // ainda convertendo
+		if (--polls_left == 0) return fail(TWI_TIMEOUT);   // Sco preso
+		return 0;
 	}
 
-	// ===== Temperatura =====
-	w8(0xF4, 0x2E);          // Comando de leitura de temperatura
-	_delay_ms(5);            // Converso demora 4.5 ms
-	uint16_t ut = r16(0xF6); // L temperatura bruta
+	if (state == ST_TEMP) {
+		if ((st = rd(0xF6, d, 2)) != TWI_OK) return fail(st);    // UT (MSB, LSB)
+		ut = ((uint16_t)d[0] << 8) | d[1];
+		bmp180_start_pressure();
+		return state == ST_READY;
+	}
 
-	// Frmulas do datasheet (compensao)
-	int32_t x1 = ((int32_t)ut - AC6) * AC5 / 32768;
-	int32_t x2 = ((int32_t)MC * 2048) / (x1 + MD);
-	b5 = x1 + x2;
+	// Leitura de 3 bytes (MSB, LSB, XLSB) num nico burst
+	if ((st = rd(0xF6, d, 3)) != TWI_OK) return fail(st);
+	up = ((uint32_t)d[0] << 16) | ((uint16_t)d[1] << 8) | d[2];
+	up >>= (8 - oss);        // XLSB s tem oss bits vlidos
+	state = ST_READY;
+	return 1;
+}
 
-	// Converte para C com 1 decimal
-	*temperature = ((b5 + 8) >> 4) / 10.0f;
+// =======================================================
+// Compensao (frmulas do datasheet) sobre o ltimo UT/UP lidos
+// Sada inteira: temperatura em centsimos de C, presso em Pa.
+// Em falha retorna o status e deixa *t_centi e *p_pa com o valor
+// anterior (dado velho).
+// =======================================================
+twi_status_t bmp180_result_raw(int16_t *t_centi, int32_t *p_pa) {
 
-	// ===== Presso =====
-	w8(0xF4, 0x34);          // Comando de leitura da presso (OSS = 0)
-	_delay_ms(8);            // Converso ~7.5 ms
+	// Se calibrao invlida
+	if (!calib_ok()) {
+		*t_centi = 0;
+		*p_pa = 0;
+		return TWI_NACK;
+	}
+	if (state != ST_READY) return TWI_BUSY;
+	state = ST_IDLE;
+	if (last_st != TWI_OK) return last_st;
+	PROF_PUSH(PROF_BMP180);
 
-	// Leitura de 3 bytes (MSB, LSB, XLSB)
-	uint32_t up = ((uint32_t)r16(0xF6) << 8) | r8(0xF8);
-	up >>= 8;                // Ajuste porque OSS=0
+	// Frmulas do datasheet (compensao). Os termos de temperatura s so
+	// recalculados quando UT muda; as divises por 2^n viram deslocamentos
+	// (com o mesmo arredondamento para zero do '/') e as por MD + x1 e b4
+	// usam o recproco.
+	if (!k_valid || ut != k_ut) {
+		int32_t x1 = ((int32_t)ut - AC6) * AC5;
+		x1 = (x1 < 0 ? x1 + 32767 : x1) >> 15;            // / 32768
+		b5 = x1 + sdiv(mc_11, x1 + MD);
 
-	// Mais frmulas longas do datasheet
-	int32_t b6 = b5 - 4000;
-	x1 = (B2 * ((b6 * b6) >> 12)) >> 11;
-	x2 = (AC2 * b6) >> 11;
-	int32_t x3 = x1 + x2;
+		int32_t b6 = b5 - 4000;
+		int32_t b6sq = (b6 * b6) >> 12;
+		k_b3x = ac1_4 + ((B2 * b6sq) >> 11) + ((AC2 * b6) >> 11);
 
-	int32_t b3 = (((((int32_t)AC1) * 4 + x3) + 2) >> 2);
+		int32_t x3 = ((((int32_t)AC3 * b6) >> 13) + ((B1 * b6sq) >> 16) + 2) >> 2;
+		k_b4 = (AC4 * (uint32_t)(x3 + 32768)) >> 15;
+		if (k_b4 >= RECIP_MIN && k_b4 <= 0xFFFF) recip_set(&k_b4r, (uint16_t)k_b4);
+		else k_b4r.d = 0;
 
-	x1 = (AC3 * b6) >> 13;
-	x2 = (B1 * ((b6 * b6) >> 12)) >> 16;
-	x3 = ((x1 + x2) + 2) >> 2;
+		k_ut = ut;
+		k_valid = 1;
+	}
 
-	uint32_t b4 = (AC4 * (uint32_t)(x3 + 32768)) >> 15;
-	uint32_t b7 = ((uint32_t)up - b3) * 50000;
+	int32_t b3 = ((k_b3x << oss) + 2) >> 2;
+	uint32_t b7 = ((uint32_t)up - b3) * (50000 >> oss);
 
-	int32_t p;
-	if (b7 < 0x80000000)
-	p = (b7 << 1) / b4;    // Caminho para valores menores
+	int32_t p, x1, x2;
+	if (k_b4r.d) {
+		if (b7 < 0x80000000)
+		p = recip_div(&k_b4r, b7 << 1);
+		else
+		p = recip_div(&k_b4r, b7) << 1;
+	} else if (b7 < 0x80000000)
+	p = (b7 << 1) / k_b4;    // b4 fora da faixa do recproco
 	else
-	p = (b7 / b4) << 1;    // Caminho para valores grandes
+	p = (b7 / k_b4) << 1;
 
 	// Compensao final
 	x1 = (p >> 8) * (p >> 8);
@@ -147,5 +309,39 @@ void bmp180_read(float *temperature, float *pressure) {
 	x2 = (-7357 * p) >> 16;
 	p = p + ((x1 + x2 + 3791) >> 4);
 
-	*pressure = p / 100.0f; // Converte para hPa (hectopascal)
+	*t_centi = (int16_t)(((b5 + 8) >> 4) * 10);   // resoluo do sensor: 0.1 C
+	*p_pa = p;
+	PROF_POP();
+	return TWI_OK;
+}
+
+#if BMP180_FLOAT_API
+twi_status_t bmp180_result(float *temperature, float *pressure) {
+	int16_t t;
+	int32_t p;
+	twi_status_t st = bmp180_result_raw(&t, &p);
+	if (st == TWI_OK || st == TWI_NACK) {
+		*temperature = t / 100.0f;   // C
+		*pressure = p / 100.0f;      // Converte para hPa (hectopascal)
+	}
+	return st;
+}
+#endif
+
+// =======================================================
+// Leitura completa bloqueante (temperatura + presso)
+// Cada consulta ao Sco  uma transao IC, durante a qual a CPU dorme em idle.
+// =======================================================
+twi_status_t bmp180_read_raw(int16_t *t_centi, int32_t *p_pa) {
+	bmp180_start_temp();
+	while (!bmp180_poll());
+	return bmp180_result_raw(t_centi, p_pa);
+}
+
+#if BMP180_FLOAT_API
+twi_status_t bmp180_read(float *temperature, float *pressure) {
+	bmp180_start_temp();
+	while (!bmp180_poll());
+	return bmp180_result(temperature, pressure);
 }
+#endif
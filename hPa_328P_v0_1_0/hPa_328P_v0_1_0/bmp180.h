@@ -2,10 +2,50 @@
 #define BMP180_H
 #include <avr/io.h>
 #include <stdint.h>
+#include "twi_master.h"
 
 #define BMP180_ADDR 0x77
+#define BMP180_SPEED TWI_SPEED_400K     // fast mode (limitado pelo F_CPU)
 
-void bmp180_init(void);
-void bmp180_read(float *temperature, float *pressure);
+// Oversampling da presso: 0 = ultra low power (4.5 ms) .. 3 = ultra high
+// resolution (25.5 ms, ~0.03 hPa de rudo RMS contra ~0.06 hPa no OSS 0)
+#ifndef BMP180_OSS_DEFAULT
+#define BMP180_OSS_DEFAULT 0
+#endif
+
+// 0 remove as funes com float (bmp180_read/bmp180_result) da compilao
+#ifndef BMP180_FLOAT_API
+#define BMP180_FLOAT_API 1
+#endif
+
+// Calibrao: 22 bytes brutos a partir de 0xAA (big-endian)
+#define BMP180_CALIB_REG  0xAA
+#define BMP180_CALIB_LEN  22
+#define BMP180_STARTUP_MS 10      // start-up mximo do datasheet
+
+// Espera o start-up e l a calibrao do sensor
+twi_status_t bmp180_init(void);
+// Inicializa com os bytes de calibrao j conhecidos (ex.: cache na EEPROM),
+// sem espera nem leitura. TWI_NACK se os coeficientes forem invlidos.
+twi_status_t bmp180_init_calib(const uint8_t *calib);
+
+// Leitura bloqueante: temperatura em 0.01 C e presso em Pa
+twi_status_t bmp180_read_raw(int16_t *t_centi, int32_t *p_pa);
+
+// API assncrona: bmp180_start_temp() dispara temperatura e, na sequncia,
+// presso; bmp180_poll() devolve 1 quando as duas terminaram (ou houve erro)
+// e bmp180_result_raw() aplica a compensao e informa o status.
+twi_status_t bmp180_start_temp(void);
+twi_status_t bmp180_start_pressure(void);
+uint8_t bmp180_poll(void);
+void bmp180_set_oss(uint8_t oss);            // vale a partir da prxima converso
+uint16_t bmp180_conv_us(uint8_t oss);        // tempo mximo da converso de presso
+uint16_t bmp180_wait_us(void);               // at o fim da etapa em andamento (0 = parado)
+twi_status_t bmp180_result_raw(int16_t *t_centi, int32_t *p_pa);
+
+#if BMP180_FLOAT_API
+twi_status_t bmp180_read(float *temperature, float *pressure);   // C, hPa
+twi_status_t bmp180_result(float *temperature, float *pressure);
+#endif
 
 #endif
@@ -0,0 +1,185 @@
+#define F_CPU 1000000UL
+#include "bmp280.h"
+#include "twi_master.h"
+#include <util/delay.h>
+
+static int32_t t_fine;
+static uint16_t dig_T1, dig_P1;
+static int16_t  dig_T2, dig_T3;
+static int16_t  dig_P2, dig_P3, dig_P4, dig_P5, dig_P6, dig_P7, dig_P8, dig_P9;
+
+// ctrl_meas (0xF4): osrs_t = x1, osrs_p = x1 e o modo nos 2 bits de baixo
+#define BMP280_MEAS     ((1 << 5) | (1 << 2))
+#define BMP280_SLEEP    0x00
+#define BMP280_FORCED   0x01
+#define BMP280_MEASURING (1 << 3)          // status (0xF3)
+
+static twi_status_t w8(uint8_t reg, uint8_t val){
+	return twi_write_regs(BMP280_ADDR, reg, &val, 1);
+}
+
+static twi_status_t rd(uint8_t reg, uint8_t *buf, uint8_t n){
+	return twi_read_regs(BMP280_ADDR, reg, buf, n);
+}
+
+// Calibrao  little-endian (LSB no endereo menor)
+static uint16_t le16(const uint8_t *b){
+	return (uint16_t)b[0] | ((uint16_t)b[1] << 8);
+}
+
+static uint8_t calib_ok(void){
+	return dig_T1 != 0 && dig_P1 != 0;
+}
+
+twi_status_t bmp280_init_calib(const uint8_t *b){
+	twi_set_speed(BMP280_ADDR, BMP280_SPEED);
+
+	twi_status_t st;
+	// config: filtro desligado (t_sb no importa fora do modo normal)
+	if ((st = w8(0xF5, 0x00)) != TWI_OK) return st;
+	// ctrl_meas: sleep at o primeiro bmp280_start()
+	if ((st = w8(0xF4, BMP280_MEAS | BMP280_SLEEP)) != TWI_OK) return st;
+
+	dig_T1 = le16(&b[0]);
+	dig_T2 = (int16_t)le16(&b[2]);
+	dig_T3 = (int16_t)le16(&b[4]);
+
+	dig_P1 = le16(&b[6]);
+	dig_P2 = (int16_t)le16(&b[8]);
+	dig_P3 = (int16_t)le16(&b[10]);
+	dig_P4 = (int16_t)le16(&b[12]);
+	dig_P5 = (int16_t)le16(&b[14]);
+	dig_P6 = (int16_t)le16(&b[16]);
+	dig_P7 = (int16_t)le16(&b[18]);
+	dig_P8 = (int16_t)le16(&b[20]);
+	dig_P9 = (int16_t)le16(&b[22]);
+	return calib_ok() ? TWI_OK : TWI_NACK;
+}
+
+twi_status_t bmp280_init(void){
+	twi_set_speed(BMP280_ADDR, BMP280_SPEED);
+	_delay_ms(BMP280_STARTUP_MS);
+
+	// calib: 0x88..0x9F numa s transao
+	uint8_t b[BMP280_CALIB_LEN];
+	twi_status_t st = rd(BMP280_CALIB_REG, b, sizeof(b));
+	if (st != TWI_OK) return st;
+	return bmp280_init_calib(b);
+}
+
+// =======================================================
+// Medida forada: start -> [measuring = 0 e modo de volta a sleep] -> l
+// S o tempo da converso (~6.4 ms no x1/x1) fica com o sensor ativo.
+// =======================================================
+#define ST_IDLE   0
+#define ST_MEAS   1
+#define ST_READY  2
+
+static uint8_t  state = ST_IDLE;
+static twi_status_t last_st = TWI_OK;
+static int32_t  adc_T, adc_P;
+static uint8_t  polls_left;
+
+// t_measure mximo (datasheet, x1/x1: 1.25 + 2.3 + 2.3 + 0.575 ms) e
+// custo de uma consulta (5 bytes)
+#define BMP280_MEAS_US   6425UL
+#define BMP280_POLL_US   (5UL * 9000000UL / TWI_SCL_REAL(TWI_SCL_400K))
+#define BMP280_POLLS     ((uint8_t)(2UL * BMP280_MEAS_US / BMP280_POLL_US + 2))
+
+static uint8_t fail(twi_status_t st){
+	last_st = st;
+	state = ST_READY;
+	return 1;
+}
+
+twi_status_t bmp280_start(void){
+	if (!calib_ok()) { last_st = TWI_NACK; state = ST_READY; return TWI_NACK; }
+	twi_status_t st = w8(0xF4, BMP280_MEAS | BMP280_FORCED);
+	if (st != TWI_OK) { fail(st); return st; }
+	last_st = TWI_OK;
+	state = ST_MEAS;
+	polls_left = BMP280_POLLS;
+	return TWI_OK;
+}
+
+// Quanto dormir antes do prximo bmp280_poll(): pior caso da medida
+uint16_t bmp280_wait_us(void){
+	return state == ST_MEAS ? BMP280_MEAS_US : 0;
+}
+
+uint8_t bmp280_poll(void){
+	if (state != ST_MEAS) return 1;
+
+	twi_status_t st;
+	uint8_t d[6];
+	// status e ctrl_meas juntos: o modo volta a sleep ao fim da medida
+	if ((st = rd(0xF3, d, 2)) != TWI_OK) return fail(st);
+	if ((d[0] & BMP280_MEASURING) || (d[1] & 0x03)) {
+		if (--polls_left == 0) return fail(TWI_TIMEOUT);
+		return 0;
+	}
+
+	// burst 6B a partir de 0xF7: press (MSB, LSB, XLSB), temp (MSB, LSB, XLSB)
+	if ((st = rd(0xF7, d, 6)) != TWI_OK) return fail(st);
+	adc_P = ((uint32_t)d[0]<<12) | ((uint32_t)d[1]<<4) | (d[2]>>4);
+	adc_T = ((uint32_t)d[3]<<12) | ((uint32_t)d[4]<<4) | (d[5]>>4);
+	state = ST_READY;
+	return 1;
+}
+
+// Sada inteira: temperatura em 0.01 C, presso em Pa.
+// Compensao de 32 bits do datasheet (seo 8.2): resoluo de 1 Pa,
+// sem a aritmtica de 64 bits que o AVR emula em software.
+twi_status_t bmp280_result_raw(int16_t *t_centi, int32_t *p_pa){
+	if (!calib_ok()) { *t_centi = 0; *p_pa = 0; return TWI_NACK; }
+	if (state != ST_READY) return TWI_BUSY;
+	state = ST_IDLE;
+	if (last_st != TWI_OK) return last_st;
+
+	// temp
+	int32_t var1 = (((adc_T>>3) - ((int32_t)dig_T1<<1)) * (int32_t)dig_T2) >> 11;
+	int32_t var2 = ((((adc_T>>4) - (int32_t)dig_T1) * ((adc_T>>4) - (int32_t)dig_T1)) >> 12) * (int32_t)dig_T3 >> 14;
+	t_fine = var1 + var2;
+	int16_t t = (int16_t)((t_fine * 5 + 128) >> 8);
+
+	// pressure (Bosch, 32-bit)
+	var1 = (t_fine >> 1) - 64000;
+	var2 = (((var1 >> 2) * (var1 >> 2)) >> 11) * (int32_t)dig_P6;
+	var2 = var2 + ((var1 * (int32_t)dig_P5) << 1);
+	var2 = (var2 >> 2) + ((int32_t)dig_P4 << 16);
+	var1 = ((((int32_t)dig_P3 * (((var1 >> 2) * (var1 >> 2)) >> 13)) >> 3) + (((int32_t)dig_P2 * var1) >> 1)) >> 18;
+	var1 = ((32768 + var1) * (int32_t)dig_P1) >> 15;
+
+	// Divisor nulo s com calibrao ou leitura degenerada: a amostra 
+	// descartada (sadas intactas) em vez de virar uma queda para 0 Pa
+	if (var1 == 0) return TWI_DATA_ERROR;
+
+	uint32_t p = ((uint32_t)(1048576 - adc_P) - (var2 >> 12)) * 3125;
+	if (p < 0x80000000)
+	p = (p << 1) / (uint32_t)var1;
+	else
+	p = (p / (uint32_t)var1) * 2;
+	var1 = ((int32_t)dig_P9 * (int32_t)(((p >> 3) * (p >> 3)) >> 13)) >> 12;
+	var2 = ((int32_t)(p >> 2) * (int32_t)dig_P8) >> 13;
+	*t_centi = t;
+	*p_pa = (int32_t)p + ((var1 + var2 + dig_P7) >> 4);
+	return TWI_OK;
+}
+
+twi_status_t bmp280_read_raw(int16_t *t_centi, int32_t *p_pa){
+	bmp280_start();
+	while (!bmp280_poll());
+	return bmp280_result_raw(t_centi, p_pa);
+}
+
+#if BMP280_FLOAT_API
+twi_status_t bmp280_read(float *temperature, float *pressure){
+	int16_t t; int32_t p;
+	twi_status_t st = bmp280_read_raw(&t, &p);
+	if (st == TWI_OK || st == TWI_NACK) {
+		*temperature = t / 100.0f;
+		*pressure = p / 100.0f;        // Pa -> hPa
+	}
+	return st;
+}
+#endif
@@ -0,0 +1,47 @@
+#ifndef BMP280_H
+#define BMP280_H
+#include <avr/io.h>
+#include <stdint.h>
+#include "twi_master.h"
+
+// AJUSTE AQUI se seu BMP280 estiver em 0x76 (SDO no GND); o baro.c usa o
+// mesmo endereo na deteco e na calibrao
+#ifndef BMP280_ADDR
+//#define BMP280_ADDR 0x76
+#define BMP280_ADDR 0x77
+#endif
+#define BMP280_SPEED TWI_SPEED_400K     // fast mode (limitado pelo F_CPU)
+
+// 0 remove bmp280_read (float) da compilao
+#ifndef BMP280_FLOAT_API
+#define BMP280_FLOAT_API 1
+#endif
+
+// Calibrao: 24 bytes brutos a partir de 0x88 (little-endian)
+#define BMP280_CALIB_REG  0x88
+#define BMP280_CALIB_LEN  24
+#define BMP280_STARTUP_MS 2       // start-up mximo do datasheet
+
+// Sensor fica em sleep; cada medida  um disparo em modo forado
+// (osrs_t = osrs_p = x1, filtro desligado: perfil "weather monitoring")
+twi_status_t bmp280_init(void);
+// Inicializa com os bytes de calibrao j conhecidos (ex.: cache na EEPROM),
+// sem espera nem leitura. TWI_NACK se os coeficientes forem invlidos.
+twi_status_t bmp280_init_calib(const uint8_t *calib);
+
+// Leitura bloqueante: temperatura em 0.01 C e presso em Pa
+twi_status_t bmp280_read_raw(int16_t *t_centi, int32_t *p_pa);
+
+// API assncrona: bmp280_start() dispara uma medida forada, bmp280_poll()
+// devolve 1 quando ela terminou (ou houve erro) e bmp280_result_raw()
+// aplica a compensao e informa o status.
+twi_status_t bmp280_start(void);
+uint8_t bmp280_poll(void);
+uint16_t bmp280_wait_us(void);               // at o fim da medida (0 = parado)
+twi_status_t bmp280_result_raw(int16_t *t_centi, int32_t *p_pa);
+
+#if BMP280_FLOAT_API
+twi_status_t bmp280_read(float *temperature, float *pressure);   // C, hPa
+#endif
+
+#endif
@@ -0,0 +1,52 @@
+#define F_CPU 1000000UL
+#include "btn.h"
+#include <avr/interrupt.h>
+
+// Timer1 em CTC com prescaler 64: 15625 Hz a 1 MHz
+#define BTN_OCR  ((uint16_t)(F_CPU / 64 * BTN_DEBOUNCE_MS / 1000 - 1))
+
+static void (*press_cb)(void);
+static volatile uint8_t debouncing;
+static volatile uint8_t down;
+
+static void debounce_start(void) {
+	TCCR1A = 0;
+	TCNT1 = 0;
+	OCR1A = BTN_OCR;
+	TIFR1 = (1 << OCF1A);
+	TIMSK1 = (1 << OCIE1A);
+	TCCR1B = (1 << WGM12) | (1 << CS11) | (1 << CS10);   // CTC, prescaler 64
+	debouncing = 1;
+}
+
+void btn_init(void (*on_press)(void)) {
+	press_cb = on_press;
+	DDRB &= ~(1 << BTN_PIN);             // entrada
+	PORTB |= (1 << BTN_PIN);             // pull-up
+	down = !(PINB & (1 << BTN_PIN));
+	PCIFR = (1 << PCIF0);
+	PCMSK0 |= (1 << BTN_PCINT);
+	PCICR |= (1 << PCIE0);
+}
+
+uint8_t btn_busy(void) {
+	return debouncing;
+}
+
+// Qualquer borda: ignora o pino at o fim do debounce
+ISR(PCINT0_vect) {
+	PCMSK0 &= ~(1 << BTN_PCINT);
+	debounce_start();
+}
+
+// Fim do debounce: vale o nvel que ficou; volta a escutar o pino
+ISR(TIMER1_COMPA_vect) {
+	TCCR1B = 0;
+	TIMSK1 = 0;
+	uint8_t now_down = !(PINB & (1 << BTN_PIN));
+	if (now_down && !down && press_cb) press_cb();
+	down = now_down;
+	debouncing = 0;
+	PCIFR = (1 << PCIF0);
+	PCMSK0 |= (1 << BTN_PCINT);
+}
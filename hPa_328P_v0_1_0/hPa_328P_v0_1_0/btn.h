@@ -0,0 +1,20 @@
+#ifndef BTN_H
+#define BTN_H
+#include <avr/io.h>
+#include <stdint.h>
+
+// Boto em PB2 (PCINT2, grupo PCINT0) com pull-up interno, ativo em 0.
+// A mudana de nvel acorda a CPU at do power-down; o debounce  um
+// disparo nico do Timer1 que rel o pino depois de BTN_DEBOUNCE_MS.
+#define BTN_PIN          PB2
+#define BTN_PCINT        PCINT2
+#define BTN_DEBOUNCE_MS  30
+
+// on_press  chamado na ISR do Timer1 a cada aperto confirmado
+void btn_init(void (*on_press)(void));
+
+// 1 enquanto o pino est em debounce: o Timer1  sncrono e s conta fora
+// do power-down, ento quem dorme deve usar IDLE nesse intervalo
+uint8_t btn_busy(void);
+
+#endif
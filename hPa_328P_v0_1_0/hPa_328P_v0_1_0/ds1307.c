@@ -6,7 +6,7 @@
  */
 
 #include "ds1307.h"
-#include "twi_master.h"   // usamos twi_start(), twi_write(), twi_read_ack(), twi_read_nack(), twi_stop()
+#include "twi_master.h"   // usamos twi_read_regs()/twi_write_regs() (via ISR)
 
 // -----------------------------
 // Funes auxiliares BCD <-> decimal
@@ -24,90 +24,100 @@ static uint8_t dec2bcd(uint8_t v)
 // -----------------------------
 // Inicializao do DS1307
 // -----------------------------
-void ds1307_init(void)
+twi_status_t ds1307_init(void)
 {
+    twi_set_speed(DS1307_ADDR, DS1307_SPEED);
+
     // Zera o registrador de segundos e garante CH = 0 (clock rodando)
-    twi_start();
-    twi_write(DS1307_ADDR << 1);  // SLA+W
-    twi_write(0x00);              // endereo do registrador de segundos
-    twi_write(0x00);              // segundos = 0, CH = 0
-    twi_stop();
+    uint8_t sec = 0x00;             // segundos = 0, CH = 0
+    twi_status_t st = twi_write_regs(DS1307_ADDR, 0x00, &sec, 1);
+    if (st != TWI_OK) return st;
+
+    // Controle (0x07): SQW/OUT em 1 Hz, base de tempo do escalonador
+    uint8_t ctrl = DS1307_SQW_1HZ;
+    return twi_write_regs(DS1307_ADDR, 0x07, &ctrl, 1);
 }
 
 // -----------------------------
 // Ajuste de hora
 // -----------------------------
-void ds1307_setTime(rtc_time *t)
+twi_status_t ds1307_setTime(rtc_time *t)
 {
-    twi_start();
-    twi_write(DS1307_ADDR << 1);  // SLA+W
-    twi_write(0x00);              // comea em segundos
-
-    twi_write(dec2bcd(t->sec));
-    twi_write(dec2bcd(t->min));
-    twi_write(dec2bcd(t->hour));
+    uint8_t b[3];
+    b[0] = dec2bcd(t->sec);         // comea em segundos (0x00)
+    b[1] = dec2bcd(t->min);
+    b[2] = dec2bcd(t->hour);
 
-    twi_stop();
+    return twi_write_regs(DS1307_ADDR, 0x00, b, 3);
 }
 
 // -----------------------------
 // Ajuste de data
 // -----------------------------
-void ds1307_setDate(rtc_date *d)
+twi_status_t ds1307_setDate(rtc_date *d)
 {
-    twi_start();
-    twi_write(DS1307_ADDR << 1);  // SLA+W
-    twi_write(0x03);              // comea em dia da semana
+    uint8_t b[4];
+    b[0] = dec2bcd(d->weekday);     // comea em dia da semana (0x03)
+    b[1] = dec2bcd(d->day);
+    b[2] = dec2bcd(d->month);
+    b[3] = dec2bcd(d->year - 2000);
 
-    twi_write(dec2bcd(d->weekday));
-    twi_write(dec2bcd(d->day));
-    twi_write(dec2bcd(d->month));
-    twi_write(dec2bcd(d->year - 2000));
-
-    twi_stop();
+    return twi_write_regs(DS1307_ADDR, 0x03, b, 4);
 }
 
 // -----------------------------
-// Leitura de hora
+// Converso dos registradores 0x00..0x06 (BCD)
 // -----------------------------
-void ds1307_getTime(rtc_time *t)
+static void decode_time(const uint8_t *b, rtc_time *t)
 {
-    // 1) posiciona ponteiro no registrador 0x00
-    twi_start();
-    twi_write(DS1307_ADDR << 1);  // SLA+W
-    twi_write(0x00);              // registrador de segundos
-    twi_stop();
-
-    // 2) leitura sequencial: sec, min, hour
-    twi_start();
-    twi_write((DS1307_ADDR << 1) | 1);   // SLA+R
+    t->sec  = bcd2dec(b[0] & 0x7F); // limpa bit CH
+    t->min  = bcd2dec(b[1]);
+    t->hour = bcd2dec(b[2]);
+}
 
-    t->sec  = bcd2dec(twi_read_ack() & 0x7F); // limpa bit CH
-    t->min  = bcd2dec(twi_read_ack());
-    t->hour = bcd2dec(twi_read_nack());
+static void decode_date(const uint8_t *b, rtc_date *d)
+{
+    d->weekday = bcd2dec(b[0]);
+    d->day     = bcd2dec(b[1]);
+    d->month   = bcd2dec(b[2]);
+    d->year    = 2000 + bcd2dec(b[3]);
+}
 
-    twi_stop();
+// -----------------------------
+// Leitura de hora
+// Em falha o struct no  alterado (fica com a ltima leitura vlida)
+// -----------------------------
+twi_status_t ds1307_getTime(rtc_time *t)
+{
+    uint8_t b[3];
+    twi_status_t st = twi_read_regs(DS1307_ADDR, 0x00, b, 3);  // sec, min, hour
+    if (st == TWI_OK) decode_time(b, t);
+    return st;
 }
 
 // -----------------------------
 // Leitura de data
+// Em falha o struct no  alterado (fica com a ltima leitura vlida)
 // -----------------------------
-void ds1307_getDate(rtc_date *d)
+twi_status_t ds1307_getDate(rtc_date *d)
 {
-    // 1) posiciona ponteiro no registrador 0x03
-    twi_start();
-    twi_write(DS1307_ADDR << 1);  // SLA+W
-    twi_write(0x03);              // dia da semana
-    twi_stop();
-
-     twi_start();
-     twi_write((DS1307_ADDR << 1) | 1);   // SLA+R
-
-     d->weekday = bcd2dec(twi_read_ack());
-     d->day     = bcd2dec(twi_read_ack());
-     d->month   = bcd2dec(twi_read_ack());
-     d->year    = 2000 + bcd2dec(twi_read_nack());
-
-     twi_stop();
-     
-}
\ No newline at end of file
+    uint8_t b[4];
+    twi_status_t st = twi_read_regs(DS1307_ADDR, 0x03, b, 4);  // weekday, day, month, year
+    if (st == TWI_OK) decode_date(b, d);
+    return st;
+}
+
+// -----------------------------
+// Leitura de hora + data num nico burst de 7 bytes (0x00..0x06)
+// Em falha os structs no so alterados
+// -----------------------------
+twi_status_t ds1307_getDateTime(rtc_time *t, rtc_date *d)
+{
+    uint8_t b[7];
+    twi_status_t st = twi_read_regs(DS1307_ADDR, 0x00, b, 7);
+    if (st == TWI_OK) {
+        decode_time(b, t);
+        decode_date(b + 3, d);
+    }
+    return st;
+}
@@ -2,8 +2,14 @@
 #define DS1307_H_
 
 #include <stdint.h>
+#include "twi_master.h"
 
 #define DS1307_ADDR 0x68
+#define DS1307_SPEED TWI_SPEED_100K     // DS1307: mx. 100 kHz
+
+// Registrador de controle (0x07): SQWE = 1, RS1:0 = 00 -> 1 Hz no SQW/OUT
+// (sada dreno aberto: pull-up externo alto no PD2, ver sched.h)
+#define DS1307_SQW_1HZ 0x10
 
 typedef struct {
 	uint8_t sec;
@@ -18,10 +24,11 @@ typedef struct {
 	uint8_t weekday;
 } rtc_date;
 
-void ds1307_init(void);
-void ds1307_setTime(rtc_time *t);
-void ds1307_setDate(rtc_date *d);
-void ds1307_getTime(rtc_time *t);
-void ds1307_getDate(rtc_date *d);
+twi_status_t ds1307_init(void);                // CH = 0 e SQW/OUT em 1 Hz
+twi_status_t ds1307_setTime(rtc_time *t);
+twi_status_t ds1307_setDate(rtc_date *d);
+twi_status_t ds1307_getTime(rtc_time *t);
+twi_status_t ds1307_getDate(rtc_date *d);
+twi_status_t ds1307_getDateTime(rtc_time *t, rtc_date *d);  // 1 burst de 7 bytes
 
 #endif
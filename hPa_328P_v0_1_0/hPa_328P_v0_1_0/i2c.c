@@ -1,49 +0,0 @@
-/*
- * i2c.c
- *
- * Created: 16/11/2025 19:38:58
- *  Author: franc
- */ 
-
-
-
-#include <avr/io.h>
-#include "i2c.h"
-
-void i2c_init()
-{
-	TWSR = 0x00;
-	TWBR = 72;  // 100kHz @ 16MHz
-}
-
-void i2c_start()
-{
-	TWCR = (1 << TWINT) | (1 << TWSTA) | (1 << TWEN);
-	while (!(TWCR & (1 << TWINT)));
-}
-
-void i2c_stop()
-{
-	TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWSTO);
-}
-
-void i2c_write(uint8_t data)
-{
-	TWDR = data;
-	TWCR = (1 << TWINT) | (1 << TWEN);
-	while (!(TWCR & (1 << TWINT)));
-}
-
-uint8_t i2c_readAck()
-{
-	TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWEA);
-	while (!(TWCR & (1 << TWINT)));
-	return TWDR;
-}
-
-uint8_t i2c_readNak()
-{
-	TWCR = (1 << TWINT) | (1 << TWEN);
-	while (!(TWCR & (1 << TWINT)));
-	return TWDR;
-}
@@ -2,50 +2,162 @@
 
 #include "lcd_i2c.h"
 
-static void i2c_out(uint8_t v){
-	twi_start();
-	twi_write((LCD_I2C_ADDR<<1) | 0);
-	twi_write(v);
-	twi_stop();
+// Bytes do PCF8574 acumulados para sair numa nica transao (uma linha
+// inteira cabe: LCD_COLS caracteres + 1 Set DDRAM, 4 bytes cada, mais um
+// byte a cada troca de RS). A
+// 100 kHz cada byte leva 90 us, o que j cobre o pulso de EN (>= 450 ns)
+// e os 37 us de execuo do HD44780 entre um caractere e o prximo.
+#define LCD_STREAM_MAX (4 * (LCD_COLS + 1) + 2)
+static uint8_t stream[LCD_STREAM_MAX];
+static uint8_t stream_len;
+static uint8_t bus_mode;    // RS do ltimo byte escrito no PCF8574 (RW fica em 0)
+
+static void stream_end(void){
+	if (stream_len) twi_transfer(LCD_I2C_ADDR, stream, stream_len, 0, 0);
+	stream_len = 0;
 }
 
-static void lcd_send_nibble(uint8_t nibble, uint8_t mode){
+static void stream_nibble(uint8_t nibble, uint8_t mode){
 	uint8_t d = (nibble & 0xF0) | mode | LCD_BACKLIGHT;
-	i2c_out(d | LCD_ENABLE);
-	_delay_us(1);
-	i2c_out(d & ~LCD_ENABLE);
-	_delay_us(50);
+	if (mode != bus_mode) {                  // RS troca com EN baixo, antes da subida (tAS)
+		stream[stream_len++] = d;
+		bus_mode = mode;
+	}
+	stream[stream_len++] = d | LCD_ENABLE;   // EN alto
+	stream[stream_len++] = d & ~LCD_ENABLE;  // EN baixo: HD44780 captura o nibble
+}
+
+static void stream_byte(uint8_t val, uint8_t mode){
+	if (stream_len > LCD_STREAM_MAX - 5) stream_end();
+	stream_nibble(val & 0xF0, mode);
+	stream_nibble((val<<4) & 0xF0, mode);
+}
+
+static void lcd_send_nibble(uint8_t nibble, uint8_t mode){
+	stream_nibble(nibble, mode);
+	stream_end();
 }
 
-static void lcd_send(uint8_t val, uint8_t mode){
-	lcd_send_nibble(val & 0xF0, mode);
-	lcd_send_nibble((val<<4) & 0xF0, mode);
+#if LCD_USE_BUSY_FLAG
+static uint8_t use_bf;      // 1 se o busy flag respondeu no lcd_init
+
+// L o busy flag: D4..D7 soltos em alto (PCF8574 quase-bidirecional), RW=1, RS=0.
+// Com EN alto o HD44780 pe BF em D7; o segundo nibble (endereo)  descartado.
+// RW s muda com EN baixo: sobe num byte prprio antes do pulso e volta a 0
+// no ltimo, para o prximo comando subir EN com RW j em 0.
+static uint8_t lcd_busy(void){
+	uint8_t d = 0xF0 | LCD_RW | LCD_BACKLIGHT;
+	uint8_t hi[2] = { d, d | LCD_ENABLE };
+	uint8_t lo[4] = { d, d | LCD_ENABLE, d, LCD_COMMAND | LCD_BACKLIGHT };
+	uint8_t v = 0x80;
+	twi_transfer(LCD_I2C_ADDR, hi, 2, &v, 1);    // RW alto, EN alto e l os pinos do PCF8574
+	twi_transfer(LCD_I2C_ADDR, lo, 4, 0, 0);     // EN baixo, pulso do nibble baixo, RW baixo
+	bus_mode = LCD_COMMAND;
+	return v & 0x80;
+}
+#endif
+
+// Espera o fim de um comando: pelo busy flag quando disponvel,
+// seno pelo pior caso do datasheet (LCD_WAIT_MS)
+static void lcd_wait_ready(void){
+#if LCD_USE_BUSY_FLAG
+	if (use_bf) {
+		for (uint8_t n = 0; n < LCD_BUSY_MAX_POLLS; n++)
+			if (!lcd_busy()) return;
+	}
+#endif
+	_delay_ms(LCD_WAIT_MS);
 }
 
-static void cmd(uint8_t c){ lcd_send(c, LCD_COMMAND); _delay_ms(2); }
+static void cmd(uint8_t c){ stream_byte(c, LCD_COMMAND); stream_end(); lcd_wait_ready(); }
+
+// Framebuffer (o que se quer mostrar) e sombra da DDRAM (o que est no display)
+static char fb[LCD_ROWS * LCD_COLS];
+static char shadow[LCD_ROWS * LCD_COLS];
+static uint8_t fb_pos;      // prxima clula escrita por lcd_print
+static uint8_t ddram;       // endereo atual do contador de endereo do HD44780
+
+static const uint8_t row_offs[LCD_ROWS] = {0x00,0x40,0x14,0x54};
+
+void lcd_clear(void){
+	for (uint8_t i = 0; i < sizeof(fb); i++) fb[i] = ' ';
+	fb_pos = 0;
+}
 
-void lcd_clear(void){ cmd(0x01); _delay_ms(2); }
-void lcd_home(void){ cmd(0x02); _delay_ms(2); }
+void lcd_home(void){ fb_pos = 0; }
 
 void lcd_set_cursor(uint8_t col, uint8_t row){
-	static const uint8_t offs[] = {0x00,0x40,0x14,0x54};
-	cmd(0x80 | (offs[row] + col));
+	fb_pos = row * LCD_COLS + col;
+}
+
+void lcd_flush(void){
+	uint8_t i = 0;
+	for (uint8_t row = 0; row < LCD_ROWS; row++) {
+		for (uint8_t col = 0; col < LCD_COLS; col++, i++) {
+			if (fb[i] == shadow[i]) continue;
+			uint8_t addr = row_offs[row] + col;
+			if (addr != ddram)
+				stream_byte(0x80 | addr, LCD_COMMAND);  // Set DDRAM s onde a sequncia quebra
+			stream_byte(fb[i], LCD_DATA);
+			shadow[i] = fb[i];
+			ddram = addr + 1;                         // auto-incremento (entry mode 0x06)
+		}
+	}
+	stream_end();
 }
 
 void lcd_init(void){
+	twi_set_speed(LCD_I2C_ADDR, LCD_I2C_SPEED);
 	_delay_ms(40);
 	lcd_send_nibble(0x30, LCD_COMMAND); _delay_ms(5);
 	lcd_send_nibble(0x30, LCD_COMMAND); _delay_us(150);
 	lcd_send_nibble(0x20, LCD_COMMAND); // 4-bit
+	_delay_us(100);
+
+#if LCD_USE_BUSY_FLAG
+	// S quando ler o BF custa menos que a espera fixa; R/W no GND: D7 l
+	// sempre 1 (pull-up do PCF8574)
+	use_bf = LCD_BF_POLL_US < LCD_WAIT_MS * 1000UL && !lcd_busy();
+#endif
 
 	cmd(0x28); // 4-bit, 2 linhas, 5x8
 	cmd(0x0C); // display ON, cursor OFF
 	cmd(0x06); // entry mode
+	cmd(0x01); // clear fsico: nica vez, depois s o framebuffer
+
 	lcd_clear();
+	for (uint8_t i = 0; i < sizeof(shadow); i++) shadow[i] = ' ';
+	ddram = 0;
 }
 
 void lcd_print(const char *s){
-	while(*s) lcd_send(*s++, LCD_DATA);
+	while (*s && fb_pos < sizeof(fb)) fb[fb_pos++] = *s++;
+}
+
+void lcd_put_fixed(int32_t value, uint8_t int_digits, uint8_t frac_digits){
+	char buf[14];                       // "-2147483648" + '.' + '\0' com folga
+	uint8_t i = sizeof(buf);
+	uint32_t u = value < 0 ? -(uint32_t)value : (uint32_t)value;
+
+	buf[--i] = 0;
+	for (uint8_t f = 0; f < frac_digits; f++) { buf[--i] = '0' + u % 10; u /= 10; }
+	if (frac_digits) buf[--i] = '.';
+
+	uint8_t int_end = i;
+	do { buf[--i] = '0' + u % 10; u /= 10; } while (u);
+	if (value < 0) buf[--i] = '-';
+	while ((uint8_t)(int_end - i) < int_digits && i) buf[--i] = ' ';
+
+	lcd_print(&buf[i]);
+}
+
+void lcd_put_u(uint16_t v, uint8_t width){
+	lcd_put_fixed(v, width, 0);
+}
+
+void lcd_put_2d(uint8_t v){
+	char buf[3] = { '0' + (v / 10) % 10, '0' + v % 10, 0 };
+	lcd_print(buf);
 }
 
 void lcd_printf(const char *fmt, ...){
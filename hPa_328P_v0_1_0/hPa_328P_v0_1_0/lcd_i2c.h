@@ -13,12 +13,38 @@
 
 // ajuste se necessrio (0x20..0x27)
 #define LCD_I2C_ADDR 0x27
+#define LCD_I2C_SPEED TWI_SPEED_100K   // PCF8574: mx. 100 kHz
+#define LCD_I2C_SCL   TWI_SCL_100K     // SCL do perfil acima
 
 #define LCD_BACKLIGHT 0x08
 #define LCD_ENABLE    0x04
+#define LCD_RW        0x02
 #define LCD_COMMAND   0
 #define LCD_DATA      1
 
+// Espera fixa depois de um comando (clear/home = 1.52 ms no pior caso)
+#define LCD_WAIT_MS   2
+
+// 1 = espera comandos lendo o busy flag (D7) pelo PCF8574; se o mdulo
+// tiver R/W ligado ao GND o lcd_init detecta e volta aos atrasos fixos.
+// Uma leitura so 2 transaes, ~10 bytes no barramento (LCD_BF_POLL_US),
+// e s vale quando sai mais barata que LCD_WAIT_MS: a 1 MHz o SCL fica em
+// ~27.8 kHz e a leitura leva ~3.2 ms, ento ficam os atrasos fixos; com
+// F_CPU de 4 MHz (100 kHz reais, ~0.9 ms) o busy flag passa a compensar.
+#ifndef LCD_USE_BUSY_FLAG
+#define LCD_USE_BUSY_FLAG 1
+#endif
+#ifndef LCD_BF_POLL_US
+#define LCD_BF_POLL_US (10 * TWI_US_BYTE(LCD_I2C_SCL))
+#endif
+#define LCD_BUSY_MAX_POLLS 8
+
+#define LCD_COLS      20
+#define LCD_ROWS      4
+
+// lcd_clear/lcd_home/lcd_set_cursor/lcd_print/lcd_printf escrevem num
+// framebuffer em RAM; nada vai ao display at lcd_flush(), que envia s
+// as clulas que mudaram desde o ltimo flush.
 void lcd_init(void);
 void lcd_clear(void);
 void lcd_home(void);
@@ -26,4 +52,12 @@ void lcd_set_cursor(uint8_t col, uint8_t row);
 void lcd_print(const char *s);
 void lcd_printf(const char *fmt, ...);
 
+// Formatao sem float (no lugar de %f, que arrasta o vfprintf_flt):
+// value em ponto fixo com frac_digits casas (ex.: 235 e 1 casa = "23.5");
+// int_digits  a largura mnima da parte inteira, sinal includo.
+void lcd_put_fixed(int32_t value, uint8_t int_digits, uint8_t frac_digits);
+void lcd_put_u(uint16_t v, uint8_t width);     // alinhado  direita com espaos
+void lcd_put_2d(uint8_t v);                    // sempre 2 dgitos ("07")
+void lcd_flush(void);
+
 #endif
@@ -0,0 +1,92 @@
+#define F_CPU 1000000UL
+#include "led.h"
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+
+typedef struct {
+	const led_pattern_t *p;    // NULL = canal parado
+	uint8_t idx;               // passo atual (par = ligado)
+	uint8_t left;              // ticks restantes no passo
+	uint8_t rounds;            // voltas restantes (0 = sem fim)
+} led_chan_t;
+
+static led_chan_t chan[LED_CHANNELS];
+
+static void timer2_start(void) {
+	if (TCCR2B) return;
+	TCNT2 = 0;
+	OCR2A = LED_OCR;
+	TCCR2A = (1 << WGM21);                       // CTC
+	TIFR2 = (1 << OCF2A);
+	TIMSK2 = (1 << OCIE2A);
+	TCCR2B = (1 << CS22) | (1 << CS21) | (1 << CS20);   // prescaler 1024
+}
+
+static void timer2_stop(void) {
+	TCCR2B = 0;
+	TIMSK2 = 0;
+}
+
+static void apply(led_chan_t *c) {
+	if (c->idx & 1) PORTB &= ~(1 << c->p->pin);
+	else            PORTB |=  (1 << c->p->pin);
+	c->left = pgm_read_byte(&c->p->steps[c->idx]);
+}
+
+void led_init(void) {
+	timer2_stop();
+	for (uint8_t i = 0; i < LED_CHANNELS; i++) chan[i].p = 0;
+}
+
+void led_play(uint8_t ch, const led_pattern_t *p) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		led_chan_t *c = &chan[ch];
+		if (c->p && c->p->pin != p->pin) PORTB &= ~(1 << c->p->pin);
+		c->p = p;
+		c->idx = 0;
+		c->rounds = p->repeat;
+		apply(c);
+		timer2_start();
+	}
+}
+
+void led_stop(uint8_t ch) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		led_chan_t *c = &chan[ch];
+		if (c->p) PORTB &= ~(1 << c->p->pin);
+		c->p = 0;
+		uint8_t any = 0;
+		for (uint8_t i = 0; i < LED_CHANNELS; i++) any |= (chan[i].p != 0);
+		if (!any) timer2_stop();
+	}
+}
+
+uint8_t led_busy(void) {
+	uint8_t busy = 0;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		for (uint8_t i = 0; i < LED_CHANNELS; i++)
+			if (chan[i].p && chan[i].rounds) busy = 1;
+	}
+	return busy;
+}
+
+ISR(TIMER2_COMPA_vect) {
+	uint8_t any = 0;
+	for (uint8_t i = 0; i < LED_CHANNELS; i++) {
+		led_chan_t *c = &chan[i];
+		if (!c->p) continue;
+		if (--c->left == 0) {
+			if (++c->idx == c->p->len) {
+				c->idx = 0;
+				if (c->rounds && --c->rounds == 0) {    // ltima volta: apaga e para
+					PORTB &= ~(1 << c->p->pin);
+					c->p = 0;
+					continue;
+				}
+			}
+			apply(c);
+		}
+		any = 1;
+	}
+	if (!any) timer2_stop();
+}
@@ -0,0 +1,43 @@
+#ifndef LED_H
+#define LED_H
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <stdint.h>
+
+// Motor de padres de LED no Timer2 (CTC, prescaler 1024): o ISR troca o
+// LED e conta as duraes, a CPU fica livre (IDLE) enquanto o padro toca.
+// O Timer2 aqui  sncrono (sem cristal de 32 kHz no TOSC), ento no roda
+// em power-down/power-save: enquanto led_busy() o sistema dorme em IDLE.
+#ifndef F_CPU
+#define F_CPU 1000000UL
+#endif
+
+#define LED_OCR       ((uint8_t)(F_CPU / 1024 / 100 - 1))          // ~10 ms
+#define LED_TICK_US   (1024UL * (LED_OCR + 1) * 1000UL / (F_CPU / 1000UL))
+#define LED_MS(ms)    ((uint8_t)(((ms) * 1000UL + LED_TICK_US / 2) / LED_TICK_US))
+
+// Canais independentes (cada um com seu pino em PORTB)
+#define LED_CH_ALERT   0
+#define LED_CH_STATUS  1
+#define LED_CHANNELS   2
+
+typedef struct {
+	uint8_t pin;               // bit em PORTB
+	uint8_t repeat;            // voltas na tabela (0 = at led_stop)
+	uint8_t len;               // nmero de duraes: liga, desliga, liga, ...
+	const uint8_t *steps;      // duraes em ticks (LED_MS), na flash
+} led_pattern_t;
+
+void led_init(void);
+
+// Comea o padro do incio (substitui o que o canal estava tocando)
+void led_play(uint8_t ch, const led_pattern_t *p);
+
+// Para o canal e apaga o LED
+void led_stop(uint8_t ch);
+
+// 1 enquanto um padro finito ainda toca (padres sem fim no seguram o
+// sistema acordado: quem chamou decide quando par-los)
+uint8_t led_busy(void);
+
+#endif
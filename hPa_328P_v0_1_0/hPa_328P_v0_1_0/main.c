@@ -4,20 +4,66 @@
 #include <avr/interrupt.h>
 #include <avr/sleep.h>
 #include <util/delay.h>
-#include <string.h>
-#include <math.h>
-#include <stdio.h>
 
 #include "twi_master.h"   // Comunicao IC
 #include "lcd_i2c.h"      // Display LCD via PCF8574
-#include "bmp180.h"       // Sensor de presso/temperatura BMP180
+#include "baro.h"         // Barmetro: BMP180 ou BMP280 (detectado no boot)
 #include "ds1307.h"       // Novo: DS1307 (RTC)
+#include "altitude.h"     // Altitude em ponto fixo (tabela)
+#include "trend.h"        // Tendncia da presso e amostragem adaptativa
+#include "adc.h"          // LM35 (ADC em noise reduction + sobreamostragem)
+#include "sched.h"        // Escalonador por tabela (base de tempo: SQW do DS1307)
+#include "led.h"          // Padres de LED no Timer2
+#include "btn.h"          // Boto por PCINT (acorda do power-down)
+#include "prof.h"         // Marcadores de fase (PROFILE = 1)
 
 // ==============================
 // Definies de parmetros
 // ==============================
-#define READ_INTERVAL_SECONDS   10       // (no est sendo usado no momento)
-#define LOW_PRESSURE_HPA        1000.0f  // Presso baixa (hPa)
+#define READ_INTERVAL_SECONDS   10       // Amostragem da presso com tendncia forte (faixa normal)
+#define BARO_MAX_INTERVAL_S     300      // Com a presso estvel o intervalo estica at aqui
+#define LM35_PERIOD_S           30       // LM35: temperatura ambiente muda devagar
+#define RTC_PERIOD_S            60       // Rel o DS1307; entre leituras conta pelo SQW
+#define ALERT_PERIOD_S          20       // Pisca de presso baixa
+#define POWER_PERIOD_S          60       // Mede VCC e reaplica a poltica de energia
+#define INTERACTIVE_REFRESH_S   2        // Modo interativo: display e presso mais rpidos
+#define INTERACTIVE_TIMEOUT_S   30       // Volta ao ritmo normal sem apertos nesse tempo
+#define LOW_PRESSURE_PA         100000L  // Presso baixa (1000 hPa)
+#define BARO_OSS                3        // BMP180 em ultra alta resoluo (menos rudo na tendncia)
+
+// ==============================
+// Poltica de energia por tenso da bateria (VCC pelo bandgap)
+// ==============================
+// Faixas pensadas para 3-4 pilhas AA / 5 V nominal; a primeira linha cuja
+// tenso mnima  atingida vale. Para subir de faixa a tenso precisa passar
+// do mnimo em POWER_HYST_MV (evita oscilar na fronteira).
+#define POWER_HYST_MV           100
+
+typedef struct {
+	uint16_t min_mv;       // vale a partir desta tenso
+	uint8_t  interval_s;   // intervalo mnimo entre amostras (o adaptativo estica)
+	uint8_t  led_alert;    // pisca o LED de presso baixa
+	uint8_t  lcd_every;    // redesenha o LCD a cada N amostras (0 = congela)
+	uint8_t  backlight;    // backlight permitido no boto
+} power_mode_t;
+
+static const power_mode_t power_modes[] = {
+	{ 4400, READ_INTERVAL_SECONDS, 1, 1, 1 },   // normal
+	{ 4000,  30, 1, 1, 1 },   // economia: amostra menos
+	{ 3600,  60, 0, 2, 0 },   // baixa: sem alertas/backlight, LCD a cada 2
+	{    0, 240, 0, 0, 0 },   // crtica: s mede, LCD congelado
+};
+#define POWER_MODES (sizeof(power_modes) / sizeof(power_modes[0]))
+
+// Escolhe a faixa da tenso medida: piora na hora, melhora uma faixa por
+// vez e s com folga de POWER_HYST_MV
+static uint8_t power_select(uint16_t vcc_mv, uint8_t cur) {
+	uint8_t m = 0;
+	while (m < POWER_MODES - 1 && vcc_mv < power_modes[m].min_mv) m++;
+	if (m >= cur) return m;
+	if (vcc_mv >= power_modes[cur - 1].min_mv + POWER_HYST_MV) return cur - 1;
+	return cur;
+}
 
 // ==============================
 // Configurao dos pinos do LED
@@ -26,96 +72,261 @@
 #define LED_DDR  DDRB
 #define LED_PIN  PB0
 
-#define LED_STATUS_PIN PB4   // LED de atividade (Timer1)
+#define LED_STATUS_PIN PB4   // LED de atividade (pisca enquanto acordado)
 
 // ==============================
 // Outros pinos usados no projeto
 // ==============================
-#define BTN_PIN  PB2      // Boto
-#define BL_PIN   PB1      // Backlight do LCD (on/off)
-
-// ==============================
-// Canal analgico do sensor LM35
-// ==============================
-#define LM35_CHANNEL PC0
+#define BL_PIN   PB1      // Backlight do LCD (on/off); boto em btn.h (PB2)
 
 // Variveis globais
-volatile uint8_t wdt_ticks = 0;
-float press_ref = 1013.25f;  // Presso de referncia ao ligar
+int32_t press_ref = 101325;  // Presso de referncia ao ligar (Pa)
 uint8_t screen = 0;          // 0 = Tela barmetro / 1 = Tela relgio
-
-// ============ TIMER1 para piscar PB4 apenas quando acordado ===============
-void timer1_init_ctc(void){
-	TCCR1A = 0;
-	TCCR1B = (1 << WGM12) | (1 << CS12) | (1 << CS10); // CTC, prescaler 1024
-	OCR1A = 488;                // Aproximadamente ~0,5 s @ 1 MHz (pisca "devagar")
-	TIMSK1 = (1 << OCIE1A);     // Habilita interrupo do Timer1
+uint8_t power_mode = 0;      // ndice em power_modes[]
+
+// ===================== PADRES DE LED (Timer2) =============================
+// Duraes alternando liga/desliga, em ticks do motor (LED_MS)
+static const uint8_t alert_steps[] PROGMEM = { LED_MS(300), LED_MS(300) };
+static const uint8_t status_steps[] PROGMEM = { LED_MS(500), LED_MS(500) };
+
+static const led_pattern_t alert_blink  = { LED_PIN, 5, 2, alert_steps };        // 5 piscadas, 3 s
+static const led_pattern_t status_blink = { LED_STATUS_PIN, 0, 2, status_steps }; // enquanto acordado
+
+// ===================== ESTADO ENTRE TAREFAS =================================
+static int16_t temp_bmp = 0;                // 0.01 C
+static int32_t press = 0;                   // Pa
+static twi_status_t bmp_st = TWI_OK;        // != TWI_OK: valores acima so da ltima leitura boa
+static int16_t temp_lm35 = 0;               // 0.01 C
+static rtc_time t = {0, 0, 0};              // ltima hora/data lidas do DS1307
+static rtc_date d = {1, 1, 2000, 1};
+static twi_status_t rtc_st = TWI_NACK;
+static uint16_t rtc_at;                     // sched_now() da ltima leitura do RTC
+static uint16_t vcc = 0;                    // mV
+static uint8_t interactive = 0;             // 1 = modo interativo (boto)
+static uint16_t interactive_until;          // sched_now() em que ele acaba
+
+// ===================== TAREFAS =============================================
+// Ordem da tabela = ordem de execuo quando vencem juntas: a poltica de
+// energia primeiro (ajusta perodos), depois sensores, display e alerta.
+// A tarefa do boto no tem perodo: roda por sched_trigger() no aperto.
+enum { TASK_BUTTON, TASK_POWER, TASK_BARO, TASK_LM35, TASK_RTC, TASK_DISPLAY, TASK_ALERT, TASK_COUNT };
+
+static void task_button(void);
+
+static void task_power(void);
+static void task_baro(void);
+static void task_lm35(void);
+static void task_rtc(void);
+static void task_display(void);
+static void task_alert(void);
+
+static sched_task_t tasks[TASK_COUNT] = {
+	{ task_button,  0,                     0 },
+	{ task_power,   POWER_PERIOD_S,        0 },
+	{ task_baro,    READ_INTERVAL_SECONDS, 0 },
+	{ task_lm35,    LM35_PERIOD_S,         0 },
+	{ task_rtc,     RTC_PERIOD_S,          0 },
+	{ task_display, READ_INTERVAL_SECONDS, 0 },
+	{ task_alert,   ALERT_PERIOD_S,        0 },
+};
+
+// Perodos e backlight do ritmo normal, pela faixa de bateria atual
+static void apply_power_mode(void) {
+	const power_mode_t *pm = &power_modes[power_mode];
+	sched_set_period(TASK_BARO, pm->interval_s);
+	sched_set_period(TASK_DISPLAY, pm->interval_s * pm->lcd_every);
+	sched_set_period(TASK_ALERT, pm->led_alert ? ALERT_PERIOD_S : 0);
+	PORTB &= ~(1 << BL_PIN);
 }
 
-void timer1_stop(void){
-	TIMSK1 &= ~(1 << OCIE1A);   // Desabilita interrupo
+// ---------- Boto: entra no modo interativo / troca de tela ----------
+static void on_press(void) {
+	sched_trigger(TASK_BUTTON);              // chamado na ISR do debounce
 }
 
-void timer1_start(void){
-	TIMSK1 |= (1 << OCIE1A);    // Habilita interrupo
+static void task_button(void) {
+	const power_mode_t *pm = &power_modes[power_mode];
+	if (!pm->lcd_every) return;              // bateria crtica: LCD congelado
+
+	if (interactive) {
+		screen ^= 1;                         // cada aperto troca de tela
+	} else {
+		interactive = 1;
+		sched_set_period(TASK_BARO, INTERACTIVE_REFRESH_S);
+		sched_set_period(TASK_DISPLAY, INTERACTIVE_REFRESH_S);
+		if (pm->backlight) PORTB |= (1 << BL_PIN);
+	}
+	interactive_until = sched_now() + INTERACTIVE_TIMEOUT_S;
+	task_display();                          // resposta imediata
 }
 
-ISR(TIMER1_COMPA_vect){
-	PINB |= (1 << LED_STATUS_PIN); // Pisca LED PB4 (toggle)
+// ---------- Bateria: escolhe a faixa e reprograma as outras tarefas ----------
+static void task_power(void) {
+	PROF_MARK(PROF_ADC);
+	vcc = adc_vcc_mv();
+	uint8_t m = power_select(vcc, power_mode);
+	if (m == power_mode) return;
+	power_mode = m;
+
+	const power_mode_t *pm = &power_modes[m];
+	if (!pm->lcd_every) interactive = 0;     // crtica encerra o modo interativo
+	if (!interactive) apply_power_mode();
+
+	if (!pm->lcd_every) {
+		// Faixa crtica: ltimo quadro fica no display
+		PORTB &= ~(1 << BL_PIN);
+		lcd_clear();
+		lcd_set_cursor(0, 0);
+		lcd_print("Bateria fraca");
+		lcd_set_cursor(0, 1);
+		lcd_put_fixed(vcc / 10, 1, 2);
+		lcd_print("V - LCD parado");
+		lcd_flush();
+	}
 }
 
-// ===================== WATCHDOG TIMER =======================================
-static void wdt_setup_seconds(uint8_t seconds) {
-	(void)seconds; // aqui voc est fixo em ~1s, ento no usa o parmetro
-
-	cli();
-
-	MCUSR &= ~(1<<WDRF);
-
-	WDTCSR = (1<<WDCE) | (1<<WDE);
-
-	// ~1 segundo de perodo
-	WDTCSR = (1<<WDIE) | (1<<WDP2) | (1<<WDP1);
+// ---------- Barmetro ----------
+static void task_baro(void) {
+	PROF_MARK(PROF_BARO);
+	baro_start();
+	do                                 // dorme o pior caso de cada etapa (UT, UP)
+		sched_nap_ms((baro_wait_us() + 999) / 1000);
+	while (!baro_poll());              // fim da converso (Sco / measuring)
+	bmp_st = baro_read(&temp_bmp, &press);
+	if (bmp_st != TWI_OK) return;
+
+	// Presso estvel: amostra cada vez menos; inclinao ou resduo altos
+	// voltam ao mnimo da faixa de bateria. O novo perodo vale a partir
+	// da prxima amostra (sched_set_period nunca adia o prazo j marcado).
+	trend_add(press, sched_now());
+	if (!interactive) {
+		uint8_t min_s = power_modes[power_mode].interval_s;
+		sched_set_period(TASK_BARO, trend_interval(min_s, BARO_MAX_INTERVAL_S));
+	}
+}
 
-	sei();
+// ---------- LM35 ----------
+static void task_lm35(void) {
+	PROF_MARK(PROF_ADC);
+	temp_lm35 = lm35_read_centi();
 }
 
-ISR(WDT_vect) {
-	if (wdt_ticks < 255)
-	wdt_ticks++;
+// ---------- Relgio ----------
+static void task_rtc(void) {
+	rtc_st = ds1307_getDateTime(&t, &d);
+	rtc_at = sched_now();
 }
 
-// ===================== SLEEP ================================================
-static void sleep_seconds(uint8_t seconds) {
-	wdt_ticks = 0;
+// ---------- Display: alterna entre as telas a cada execuo ----------
+static void task_display(void) {
+	PROF_MARK(PROF_LCD);
 
-	timer1_stop(); // para o pisca LED durante o sono
+	// Fim do modo interativo por inatividade: volta ao ritmo da bateria
+	if (interactive && (int16_t)(sched_now() - interactive_until) >= 0) {
+		interactive = 0;
+		apply_power_mode();
+	}
 
-	set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+	if (screen == 0) {
+		// ===================== TELA 1  BARMETRO =====================
+		lcd_clear();
+		lcd_set_cursor(0, 0);
+		lcd_print("T:");
+		lcd_put_fixed(temp_bmp / 10, 2, 1);    // 0.1 C no display
+		lcd_print("C P:");
+		lcd_put_fixed((press + 50) / 100, 4, 0);
+		lcd_print("hPa");
+		if (bmp_st != TWI_OK) {
+			lcd_set_cursor(19, 0);
+			lcd_print("*");   // dado velho: barmetro no respondeu
+		}
 
-	while (wdt_ticks < seconds) {
-		sleep_enable();
-		sleep_cpu();
-		sleep_disable();
-	}
+		lcd_set_cursor(0, 1);
+		if (press < 99600L)
+		lcd_print("Tempo: Tempestade");
+		else if (press < 100400L)
+		lcd_print("Tempo: Chuva");
+		else if (press < 101000L)
+		lcd_print("Tempo: Nublado");
+		else
+		lcd_print("Tempo: Sol");
 
-	timer1_start(); // volta a piscar LED
+		lcd_set_cursor(14,1);
+		if (trend_slope() > TREND_ARROW_PA_H)
+		lcd_print("^");   // seta pra cima (melhora)
+		else if (trend_slope() < -TREND_ARROW_PA_H)
+		lcd_print("v");   // seta pra baixo (piora)
+		else
+		lcd_print("-");   // estvel
+
+		lcd_set_cursor(0,2);
+		lcd_print("Temp LM35: ");
+		lcd_put_fixed(temp_lm35 / 10, 2, 1);
+		lcd_print("C");
+
+		lcd_set_cursor(0,3);
+		lcd_print("Altitude: ");
+		lcd_put_fixed(altitude_dm(press, press_ref), 4, 1);
+		lcd_print("m");
+	} else {
+		// ===================== TELA 2  RELOGIO DS1307 =================
+		// Hora da ltima leitura + bordas do SQW desde ento (mesmo cristal)
+		uint32_t s = t.hour * 3600UL + t.min * 60U + t.sec + (uint16_t)(sched_now() - rtc_at);
+		s %= 86400UL;
+		uint8_t hh = s / 3600, mm = (s / 60) % 60, ss = s % 60;
+
+		lcd_clear();
+		lcd_set_cursor(0,0);
+		lcd_print("Data: ");
+		lcd_put_2d(d.day);   lcd_print("/");
+		lcd_put_2d(d.month); lcd_print("/");
+		lcd_put_u(d.year, 4);
+
+		lcd_set_cursor(0,1);
+		lcd_print("Hora: ");
+		lcd_put_2d(hh); lcd_print(":");
+		lcd_put_2d(mm); lcd_print(":");
+		lcd_put_2d(ss);
+
+		lcd_set_cursor(0,2);
+		lcd_print("Semana: ");
+		lcd_put_u(d.weekday, 0);
+		lcd_set_cursor(11,2);
+		lcd_print("Bat:");
+		lcd_put_fixed(vcc / 10, 1, 2);
+		lcd_print("V");
+
+		lcd_set_cursor(0,3);
+		lcd_print(rtc_st == TWI_OK ? "Estacao ativa" : "RTC sem resposta");
+	}
+	lcd_flush();                       // envia s as clulas que mudaram
+	if (!interactive) screen ^= 1;     // no interativo quem troca  o boto
 }
 
-// ===================== ADC: LM35 ============================================
-static void adc_init(void) {
-	ADMUX = (1 << REFS0);  // AVcc como referncia
-	ADCSRA = (1 << ADEN) | (1 << ADPS1) | (1 << ADPS0);
-	// com F_CPU=1MHz => prescaler=8 => F_ADC = 125kHz
+// ---------- LED de alerta de presso baixa ----------
+// S dispara o padro; o Timer2 pisca enquanto o escalonador dorme em IDLE
+static void task_alert(void) {
+	PROF_MARK(PROF_ALERT);
+	if (press < LOW_PRESSURE_PA)
+	led_play(LED_CH_ALERT, &alert_blink);
+	else
+	led_stop(LED_CH_ALERT);
 }
 
-static uint16_t adc_read(uint8_t channel) {
-	ADMUX = (ADMUX & 0xF0) | (channel & 0x0F);
-
-	ADCSRA |= (1 << ADSC);
-	while (ADCSRA & (1 << ADSC));
+// Timers sncronos em uso (padro de LED, debounce): dormir em IDLE
+static uint8_t keep_clock(void) {
+	return led_busy() || btn_busy();
+}
 
-	return ADC;
+// Pisca de status s acordado
+static void on_sleep(uint8_t sleeping) {
+	if (sleeping) {
+		PROF_MARK(PROF_SLEEP);
+		led_stop(LED_CH_STATUS);
+	} else {
+		PROF_MARK(PROF_AWAKE);
+		led_play(LED_CH_STATUS, &status_blink);
+	}
 }
 
 // ===================== MAIN ================================================
@@ -127,127 +338,41 @@ int main(void){
 	LED_PORT &= ~(1<<LED_PIN);
 	LED_PORT &= ~(1<<LED_STATUS_PIN);
 
-	// --------- Boto e Backlight LCD ---------------
-	DDRB &= ~(1<<BTN_PIN);              // Boto como entrada
-	PORTB |= (1<<BTN_PIN);              // Pull-up no boto
-
+	// --------- Backlight LCD ---------------
 	DDRB |= (1<<BL_PIN);                // Backlight como sada
 	PORTB &= ~(1<<BL_PIN);              // Backlight desligado inicialmente
 
 	// --------- Inicializaes de perifricos --------
-	twi_init();                         // I2C para BMP180, LCD, DS1307
-	lcd_init();                         // LCD via PCF8574
-	bmp180_init();                      // BMP180
-	adc_init();                         // ADC (LM35)
-	ds1307_init();                      // DS1307 (RTC)
+	twi_init();                         // I2C para barmetro, LCD, DS1307
+	sei();                              // Habilita interrupes globais (TWI  por interrupo)
 
-	sei();                              // Habilita interrupes globais
+	lcd_init();                         // LCD via PCF8574
+	baro_init();                        // BMP180 ou BMP280 (chip ID, calibrao em cache)
+	baro_set_oss(BARO_OSS);
+	adc_init();                         // ADC (LM35), ligado s durante a leitura
+	ds1307_init();                      // DS1307 (RTC) com SQW/OUT em 1 Hz
 
-	wdt_setup_seconds(1);               // WDT ~1s
-	timer1_init_ctc();                  // Pisca LED de status
+	led_init();                         // Motor de padres (Timer2)
+	led_play(LED_CH_STATUS, &status_blink);
 
 	// --------- Leitura inicial para calibrar altitude ----------
-	float temp_dummy = 0;
-	bmp180_read(&temp_dummy, &press_ref); // Presso atual como referncia
+	int16_t temp_dummy = 0;
+	baro_read_raw(&temp_dummy, &press_ref);   // Presso atual como referncia
 
 	// --------- Tela de calibrao inicial ----------
 	lcd_clear();
 	lcd_set_cursor(0,0);
 	lcd_print("Calibrando Altitude");
 	lcd_set_cursor(0,1);
-	lcd_printf("Ref: %.2f hPa", press_ref);
-	_delay_ms(500);
-
-	// Variveis de leitura em loop
-	float temp_bmp = 0, press = 0, prev_press = 0;
-
-	while (1) {
-
-		// ===================== Leitura do BMP180 =====================
-		bmp180_read(&temp_bmp, &press);
-
-		float altitude = 44330.0f * (1.0f - pow((press / press_ref), 0.1903f));
-
-		// ===================== Leitura do LM35 =======================
-		uint16_t adc_val = adc_read(LM35_CHANNEL);
-		float temp_lm35 = ((adc_val * 5000.0f) / 1023.0f) / 10.0f;
-
-		// ===================== BACKLIGHT NO BOTO ====================
-		if (!(PINB & (1 << BTN_PIN)))
-		PORTB |= (1 << BL_PIN);   // Liga backlight
-		else
-		PORTB &= ~(1 << BL_PIN);  // Desliga backlight
-
-		// ===================== SELEO DE TELAS ======================
-		if (screen == 0) {
-			// ===================== TELA 1  BARMETRO =====================
-			lcd_clear();
-			lcd_set_cursor(0, 0);
-			lcd_printf("T:%4.1fC P:%4.0fhPa", temp_bmp, press);
-
-			lcd_set_cursor(0, 1);
-			if (press < 996.0f)
-			lcd_print("Tempo: Tempestade");
-			else if (press < 1004.0f)
-			lcd_print("Tempo: Chuva");
-			else if (press < 1010.0f)
-			lcd_print("Tempo: Nublado");
-			else
-			lcd_print("Tempo: Sol");
-
-			lcd_set_cursor(14,1);
-			if (press > prev_press + 0.3f)
-			lcd_print("^");   // seta pra cima (melhora)
-			else if (press < prev_press - 0.3f)
-			lcd_print("v");   // seta pra baixo (piora)
-			else
-			lcd_print("-");   // estvel
-
-			prev_press = press;
-
-			lcd_set_cursor(0,2);
-			lcd_printf("Temp LM35: %4.1fC", temp_lm35);
-
-			lcd_set_cursor(0,3);
-			lcd_printf("Altitude: %6.1fm", altitude);
-
-			// ---------- LED de alerta de presso baixa ----------
-			if (press < LOW_PRESSURE_HPA) {
-				for (uint8_t i = 0; i < 5; i++) {
-					LED_PORT |= (1 << LED_PIN);
-					_delay_ms(300);
-					LED_PORT &= ~(1 << LED_PIN);
-					_delay_ms(300);
-				}
-				} else {
-				LED_PORT &= ~(1 << LED_PIN);
-			}
-			} else {
-			// ===================== TELA 2  RELOGIO DS1307 =================
-			rtc_time t;
-			rtc_date d;
-
-			ds1307_getTime(&t);
-			ds1307_getDate(&d);
-
-			lcd_clear();
-			lcd_set_cursor(0,0);
-			lcd_printf("Data: %02u/%02u/%04u", d.day, d.month, d.year);
-
-			lcd_set_cursor(0,1);
-			lcd_printf("Hora: %02u:%02u:%02u", t.hour, t.min, t.sec);
-
-			lcd_set_cursor(0,2);
-			lcd_printf("Semana: %u", d.weekday);
-
-			lcd_set_cursor(0,3);
-			lcd_print("Estacao ativa");
-		}
-
-		// ===================== ECONOMIA DE ENERGIA ===================
-		sleep_seconds(10);   // Dorme 30s com WDT
-
-		// Quando acordar ? alterna tela
-		screen ^= 1;
-	}
+	lcd_print("Ref: ");
+	lcd_put_fixed(press_ref, 1, 2);      // Pa = hPa com 2 casas
+	lcd_print(" hPa");
+	lcd_flush();
+	if (!baro_from_cache())
+		_delay_ms(500);                  // s no primeiro boot com este sensor
+
+	// --------- Escalonador: SQW de 1 Hz como base de tempo (WDT de reserva) ----------
+	sched_init(tasks, TASK_COUNT);       // todas vencem j na primeira volta
+	btn_init(on_press);                  // PCINT no boto: acorda do power-down
+	sched_run(on_sleep, keep_clock);     // power-down at o prximo prazo ou aperto
 }
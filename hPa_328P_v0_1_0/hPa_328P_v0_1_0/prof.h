@@ -0,0 +1,45 @@
+/*
+ * prof.h
+ *
+ * Marcadores de fase para medir ciclos por iterao do lao principal
+ * em simulador (simavr, Proteus). Com PROFILE = 1 cada PROF_MARK() grava
+ * o id da fase em GPIOR0 (1 instruo OUT, sem efeito no hardware); o
+ * simulador registra cada escrita com o nmero do ciclo, e a diferena
+ * entre marcadores d os ciclos de cada fase e o tempo acordado/dormindo.
+ *
+ * make -C host bench compila o firmware com PROFILE = 1, roda no simavr
+ * com os modelos dos chips e grava ciclos (acordado, idle/ADC,
+ * power-down) e carga estimada de cada fase em CSV e JSON.
+ */
+
+#ifndef PROF_H_
+#define PROF_H_
+
+#include <avr/io.h>
+
+#ifndef PROFILE
+#define PROFILE 0
+#endif
+
+// Fases do lao principal (valor gravado em GPIOR0)
+#define PROF_AWAKE     1   // acordou do power-down
+#define PROF_BARO      2   // leitura do barmetro
+#define PROF_ADC       3   // leituras do ADC (LM35, VCC)
+#define PROF_LCD       4   // montagem/envio das telas
+#define PROF_ALERT     5   // pisca de alerta de presso baixa
+#define PROF_SLEEP     6   // entrando em power-down
+#define PROF_BMP180    7   // compensao do BMP180 (dentro de PROF_BARO)
+
+// PROF_PUSH/PROF_POP: fase aninhada que devolve GPIOR0  fase de quem
+// chamou (ex.: um kernel medido  parte dentro de uma tarefa)
+#if PROFILE
+#define PROF_MARK(phase)  (GPIOR0 = (phase))
+#define PROF_PUSH(phase)  uint8_t prof_prev_ = GPIOR0; GPIOR0 = (phase)
+#define PROF_POP()        (GPIOR0 = prof_prev_)
+#else
+#define PROF_MARK(phase)  ((void)0)
+#define PROF_PUSH(phase)  do { } while (0)
+#define PROF_POP()        ((void)0)
+#endif
+
+#endif
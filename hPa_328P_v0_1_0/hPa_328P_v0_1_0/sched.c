@@ -0,0 +1,183 @@
+#define F_CPU 1000000UL
+#include "sched.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+#include <util/atomic.h>
+
+static sched_task_t *task;
+static uint8_t ntask;
+static volatile uint16_t seconds;
+static volatile uint8_t pending;             // tarefas disparadas (bit = id)
+static uint8_t (*keep_clock)(void);          // do sched_run: dormir em IDLE
+
+// Base de tempo: borda de descida do SQW de 1 Hz (PCINT  assncrono e
+// acorda do power-down, ao contrrio da borda no INT0/INT1; a subida
+// tambm acorda, mas sai logo na ISR). O WDT s
+// vigia o SQW a cada ~8 s; sem bordas ele assume a contagem at o sinal
+// voltar, em passos de 1, 2, 4 ou 8 s (o maior que cabe no sono).
+static volatile uint8_t sqw_ticks;           // bordas desde o ltimo WDT
+static volatile uint8_t wdt_counts;          // 1 = SQW ausente, WDT conta
+static volatile uint8_t wdt_log2;            // passo do WDT: 1 << wdt_log2 s
+static volatile uint8_t napping;             // 1 = WDT marcando um sched_nap_ms
+
+static void wdt_set(uint8_t prescaler) {
+	WDTCSR = (1<<WDCE) | (1<<WDE);
+	WDTCSR = (1<<WDIE) | prescaler;          // s interrupo, sem reset
+}
+
+static const uint8_t wdt_step_p[4] = {     // 1, 2, 4 e 8 s
+	(1<<WDP2) | (1<<WDP1),
+	(1<<WDP2) | (1<<WDP1) | (1<<WDP0),
+	(1<<WDP3),
+	(1<<WDP3) | (1<<WDP0),
+};
+
+// Reprograma o passo; o WDT recomea, ento a frao corrida se perde
+static void wdt_step(uint8_t log2) {
+	wdt_log2 = log2;
+	wdt_reset();
+	wdt_set(wdt_step_p[log2]);
+}
+
+ISR(PCINT2_vect) {
+	if (SCHED_SQW_PIN & (1<<SCHED_SQW_BIT)) return;   // s a descida
+	if (sqw_ticks < 255) sqw_ticks++;
+	if (!wdt_counts) seconds++;
+}
+
+ISR(WDT_vect) {
+	if (napping) { napping = 0; return; }
+	if (wdt_counts) {
+		seconds += (uint8_t)(1 << wdt_log2);
+		if (sqw_ticks) { wdt_counts = 0; wdt_step(3); }   // SQW voltou
+	} else if (!sqw_ticks) {
+		seconds += 8;                        // ~8 s sem borda: assume o WDT
+		wdt_counts = 1;
+		wdt_step(0);
+	}
+	sqw_ticks = 0;
+}
+
+void sched_init(sched_task_t *tasks, uint8_t n) {
+	task = tasks;
+	ntask = n;
+	for (uint8_t i = 0; i < n; i++) task[i].next = 0;
+
+	cli();
+	SCHED_SQW_DDR &= ~(1<<SCHED_SQW_BIT);    // entrada, pull-up externo (ver sched.h)
+	SCHED_SQW_PORT &= ~(1<<SCHED_SQW_BIT);
+	PCMSK2 |= (1<<SCHED_SQW_PCINT);
+	PCIFR = (1<<PCIF2);
+	PCICR |= (1<<PCIE2);
+
+	// Comea contando pelo WDT; a primeira interrupo com bordas do SQW
+	// passa a base para ele
+	MCUSR &= ~(1<<WDRF);
+	sqw_ticks = 0;
+	wdt_counts = 1;
+	wdt_step(0);
+	sei();
+}
+
+uint16_t sched_now(void) {
+	uint16_t s;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { s = seconds; }
+	return s;
+}
+
+void sched_set_period(uint8_t id, uint16_t period_s) {
+	sched_task_t *t = &task[id];
+	uint16_t now = sched_now();
+	uint16_t next = now + period_s;
+	if (!t->period_s)
+		t->next = now;                       // estava parada: roda na hora
+	else if ((int16_t)(t->next - next) > 0)
+		t->next = next;                      // nunca adia quem j ia vencer antes
+	t->period_s = period_s;
+}
+
+void sched_trigger(uint8_t id) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { pending |= (uint8_t)(1 << id); }
+}
+
+// Um sono, com interrupes desligadas na entrada e na sada: power-down
+// (s WDT/PCINT acordam), ou IDLE enquanto keep_clock() pedir os timers
+// sncronos ativos
+static void doze(void) {
+	set_sleep_mode(keep_clock && keep_clock() ? SLEEP_MODE_IDLE : SLEEP_MODE_PWR_DOWN);
+	sleep_enable();
+	sei();                                   // sei + sleep: sem janela para perder o WDT
+	sleep_cpu();
+	sleep_disable();
+	cli();
+}
+
+// Dorme at sched_now() chegar em wake (ou uma tarefa ser disparada).
+// Com o WDT contando, cada sono usa o maior passo que no passa de wake;
+// o passo s muda depois de um estouro (os outros despertares no mexem
+// em seconds), ento quase nada da contagem se perde na troca.
+static void sleep_until(uint16_t wake) {
+	cli();
+	while ((int16_t)(seconds - wake) < 0 && !pending) {
+		if (wdt_counts) {
+			uint16_t left = wake - seconds;
+			uint8_t k = 3;
+			while (k && (1U << k) > left) k--;
+			if (k != wdt_log2) wdt_step(k);
+		}
+		doze();
+	}
+	sei();
+}
+
+void sched_nap_ms(uint16_t ms) {
+	if (!ms) return;
+	uint8_t p = 0;                           // WDP2..0: 16 ms << p
+	while (p < 7 && (16U << p) < ms) p++;
+
+	cli();
+	wdt_reset();
+	napping = 1;
+	wdt_set(p);
+	while (napping)                          // SQW e boto acordam e voltam a dormir
+		doze();
+	wdt_step(wdt_log2);                      // reserva recomea a contar daqui
+	sei();
+}
+
+void sched_run(void (*sleep_hook)(uint8_t sleeping), uint8_t (*keep)(void)) {
+	keep_clock = keep;
+	for (;;) {
+		uint8_t fired;
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { fired = pending; pending = 0; }
+
+		for (uint8_t i = 0; i < ntask; i++) {
+			sched_task_t *t = &task[i];
+			uint16_t now = sched_now();
+			uint8_t due = t->period_s && (int16_t)(now - t->next) >= 0;
+			if (due) {
+				t->next += t->period_s;
+				if ((int16_t)(now - t->next) >= 0)   // atrasou mais de um perodo
+					t->next = now + t->period_s;
+			}
+			if (due || (fired & (1 << i)))       // disparo no mexe no prximo prazo
+				t->run();
+		}
+
+		// Menor prazo entre as tarefas ativas (as tarefas podem ter demorado)
+		uint16_t now = sched_now();
+		int16_t wait = 0x7FFF;
+		for (uint8_t i = 0; i < ntask; i++) {
+			if (!task[i].period_s) continue;
+			int16_t dt = (int16_t)(task[i].next - now);
+			if (dt < wait) wait = dt;
+		}
+		if (wait <= 0 || pending) continue;
+
+		if (sleep_hook) sleep_hook(1);
+		sleep_until(now + wait);
+		if (sleep_hook) sleep_hook(0);
+	}
+}
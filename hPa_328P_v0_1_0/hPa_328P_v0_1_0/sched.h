@@ -0,0 +1,60 @@
+#ifndef SCHED_H
+#define SCHED_H
+#include <avr/io.h>
+#include <stdint.h>
+
+// Escalonador cooperativo por tabela esttica. Cada tarefa roda quando
+// vence e volta a vencer period_s segundos depois; entre uma e outra a CPU
+// fica em power-down at o menor prazo da tabela.
+//
+// Base de tempo: SQW de 1 Hz do DS1307 (ds1307_init) no PD2, via PCINT2.
+// Do power-down s o PCINT acorda numa borda (no INT0/INT1 s o nvel
+// baixo acorda), e ele v as duas: a descida conta o segundo e a subida
+// s testa o nvel na ISR e volta a dormir. Sem SQW o WDT de reserva
+// conta os segundos em passos de at 8 s.
+//
+// O SQW/OUT  dreno aberto e o pino fica sem o pull-up interno, que
+// (20-50 kohm) gastaria ~100 uA no meio segundo em que o SQW fica em 0.
+// Precisa de um pull-up externo alto para o VCC (ex.: 1 Mohm, ~5 uA).
+
+// Pino do SQW/OUT (PD2 = PCINT18)
+#define SCHED_SQW_PORT   PORTD
+#define SCHED_SQW_DDR    DDRD
+#define SCHED_SQW_PIN    PIND
+#define SCHED_SQW_BIT    PD2
+#define SCHED_SQW_PCINT  PCINT18
+
+typedef struct {
+	void (*run)(void);
+	uint16_t period_s;       // 0 = tarefa parada
+	uint16_t next;           // prximo vencimento (em sched_now())
+} sched_task_t;
+
+// Liga o PCINT do SQW e o WDT de reserva; todas as tarefas ativas vencem j
+void sched_init(sched_task_t *tasks, uint8_t n);
+
+// Segundos desde sched_init (16 bits, d a volta a cada ~18 h; os prazos
+// so comparados por diferena, ento a volta no atrapalha)
+uint16_t sched_now(void);
+
+// Troca o perodo de uma tarefa. Tarefa que estava parada vence na hora;
+// as outras vencem no mximo period_s a partir de agora.
+void sched_set_period(uint8_t id, uint16_t period_s);
+
+// Faz a tarefa id (< 8) rodar logo, fora do perodo; pode ser chamada de
+// uma ISR e interrompe o sono do escalonador (ex.: boto)
+void sched_trigger(uint8_t id);
+
+// Dorme ~ms dentro de uma tarefa (ex.: converso de um sensor) no mesmo
+// modo do lao principal, com o WDT em 16 ms << n (o menor que cobre ms,
+// at 2 s; preciso do oscilador do WDT). Bordas do SQW seguem contando
+// os segundos; com o WDT de reserva contando, o passo em curso recomea.
+void sched_nap_ms(uint16_t ms);
+
+// Lao principal (nunca retorna). sleep_hook(1)  chamado antes de dormir
+// e sleep_hook(0) ao acordar. Enquanto keep_clock() devolver 1 a espera 
+// em SLEEP_MODE_IDLE (timers sncronos, ex.: padro de LED no Timer2);
+// seno em power-down. Os dois podem ser NULL.
+void sched_run(void (*sleep_hook)(uint8_t sleeping), uint8_t (*keep_clock)(void));
+
+#endif
@@ -0,0 +1,74 @@
+#define F_CPU 1000000UL
+#include "trend.h"
+
+// Inclinao em Pa/h e varincia em Pa, ambas com 4 bits de frao:
+// com dt pequeno o peso da mdia fica em poucos /256 e o arredondamento
+// engoliria as correes
+#define Q               4
+#define SLOPE_MAX       (32767L << Q)
+#define DP_MAX          500             // salto mximo aceito entre amostras (Pa)
+#define RESID_MAX       500             // |r| <= 500 Pa: r << Q cabe no peso /256
+
+static int32_t last_p;
+static uint16_t last_t;
+static uint8_t started;
+static int32_t slope_q;                 // Pa/h << Q
+static int32_t var_q;                   // Pa << Q
+static uint16_t interval;
+
+static int32_t clamp(int32_t v, int32_t lim) {
+	return v > lim ? lim : v < -lim ? -lim : v;
+}
+
+void trend_add(int32_t p_pa, uint16_t now_s) {
+	if (!started) {                     // primeira amostra: s ponto de partida
+		last_p = p_pa;
+		last_t = now_s;
+		started = 1;
+		return;
+	}
+	uint16_t dt = now_s - last_t;
+	if (!dt) return;
+
+	int32_t dp = clamp(p_pa - last_p, DP_MAX);
+	last_p = p_pa;
+	last_t = now_s;
+
+	// Acima de 4 TAU a amostra anterior j no pesa: trata como 4 TAU
+	int32_t dtc = dt > 4 * TREND_TAU_S ? 4 * TREND_TAU_S : dt;
+
+	// Resduo contra a previso pela inclinao atual
+	int32_t r = clamp(dp - slope_q * dtc / (3600L << Q), RESID_MAX);
+
+	// Peso da mdia em /256: dt / (dt + TAU)
+	int32_t w = dtc * 256 / (dtc + TREND_TAU_S);
+	if (!w) w = 1;
+
+	int32_t s = clamp(dp * (3600L << Q) / dt, SLOPE_MAX);
+	slope_q += (s - slope_q) * w / 256;
+	var_q += ((r * r << Q) - var_q) * w / 256;
+}
+
+int16_t trend_slope(void) {
+	return (int16_t)((slope_q + (1 << (Q - 1))) >> Q);
+}
+
+uint16_t trend_var(void) {
+	int32_t v = (var_q + (1 << (Q - 1))) >> Q;
+	return v > 0xFFFF ? 0xFFFF : (uint16_t)v;
+}
+
+uint16_t trend_interval(uint16_t min_s, uint16_t max_s) {
+	int16_t s = trend_slope();
+	uint16_t a = s < 0 ? -s : s;
+	uint16_t v = trend_var();
+
+	if (!interval || a >= TREND_FAST_PA_H || v >= TREND_NOISY_PA2)
+		interval = min_s;
+	else if (a < TREND_FAST_PA_H / 2 && v < TREND_NOISY_PA2 / 2)
+		interval = interval > max_s / 2 ? max_s : interval * 2;
+
+	if (interval < min_s) interval = min_s;
+	if (interval > max_s) interval = max_s;
+	return interval;
+}
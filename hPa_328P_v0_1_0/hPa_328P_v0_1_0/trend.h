@@ -0,0 +1,44 @@
+#ifndef TREND_H
+#define TREND_H
+#include <stdint.h>
+
+// Tendncia da presso e intervalo de amostragem adaptativo.
+// A cada amostra o filtro atualiza, por mdia exponencial com peso
+// dt / (dt + TREND_TAU_S) (vale para intervalos irregulares):
+//   - a inclinao (Pa/h), a partir da diferena entre amostras;
+//   - a varincia do resduo (Pa) contra a previso pela inclinao,
+//     que pega rajadas e mudanas de regime que a mdia ainda no viu.
+// O resduo em Pa (e no a inclinao instantnea) mantm o piso de rudo
+// do sensor igual para qualquer dt.
+#ifndef TREND_TAU_S
+#define TREND_TAU_S        600     // constante de tempo das mdias
+#endif
+
+// Acima de qualquer um dos limites o intervalo volta ao mnimo; abaixo da
+// metade dos dois ele dobra a cada amostra at o mximo; entre um e outro
+// fica como est (histerese).
+#ifndef TREND_FAST_PA_H
+#define TREND_FAST_PA_H    60      // 0.6 hPa/h
+#endif
+#ifndef TREND_NOISY_PA2
+#define TREND_NOISY_PA2    100     // desvio de ~10 Pa no resduo
+#endif
+
+// Inclinao mnima para a seta de tendncia no LCD
+#ifndef TREND_ARROW_PA_H
+#define TREND_ARROW_PA_H   30      // 0.3 hPa/h
+#endif
+
+// Amostra de presso em Pa no instante now_s (em segundos, com volta)
+void trend_add(int32_t p_pa, uint16_t now_s);
+
+// Inclinao filtrada em Pa/h (positiva = subindo)
+int16_t trend_slope(void);
+
+// Varincia filtrada do resduo em Pa
+uint16_t trend_var(void);
+
+// Prximo intervalo de amostragem, entre min_s e max_s
+uint16_t trend_interval(uint16_t min_s, uint16_t max_s);
+
+#endif
@@ -1,37 +1,305 @@
 #define F_CPU 1000000UL
 #include "twi_master.h"
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <util/atomic.h>
+#include <util/delay.h>
 
-void twi_init(void) {
-	TWSR = 0x00;     // prescaler = 1
-	TWBR = 12;       // ~25 kHz em F_CPU = 1 MHz
+// TWCR para avanar a mquina de estados com a interrupo habilitada
+#define TWCR_GO   ((1<<TWINT)|(1<<TWEN)|(1<<TWIE))
+
+// Pinos do TWI no ATmega328P (usados no bus clear)
+#define TWI_SDA   PC4
+#define TWI_SCL   PC5
+
+// Limite de espera pelo fim de um STOP (~ 10 tempos de bit a 25 kHz)
+#define TWI_STOP_SPIN  40
+
+static twi_xfer_t *volatile queue[TWI_QUEUE_LEN];
+static volatile uint8_t q_head, q_count;
+
+static uint8_t pos;                 // ndice no buffer da fase atual
+static uint8_t reading;             // 0 = fase de escrita, 1 = fase de leitura
+static volatile uint16_t ticks_left; // ms restantes para a transao corrente
+
+// ============ TIMER0: prazo das transaes (1 ms, s com o barramento ocupado) ============
+static void deadline_start(void) {
+	TCNT0 = 0;
+	OCR0A = (F_CPU / 8 / 1000) - 1;         // 1 ms com prescaler 8
+	TCCR0A = (1 << WGM01);                  // CTC
+	TIFR0 = (1 << OCF0A);
+	TIMSK0 = (1 << OCIE0A);
+	TCCR0B = (1 << CS01);                   // prescaler 8
+}
+
+static void deadline_stop(void) {
+	TCCR0B = 0;
+	TIMSK0 = 0;
+}
+
+// Tabelas dos perfis (constantes de compilao, indexadas por twi_speed_t)
+static const uint8_t speed_twbr[TWI_SPEED_COUNT] = {
+	TWI_TWBR(TWI_SCL_25K), TWI_TWBR(TWI_SCL_100K), TWI_TWBR(TWI_SCL_400K)
+};
+static const uint8_t speed_twps[TWI_SPEED_COUNT] = {
+	TWI_TWPS(TWI_SCL_25K), TWI_TWPS(TWI_SCL_100K), TWI_TWPS(TWI_SCL_400K)
+};
+static const uint16_t speed_us_byte[TWI_SPEED_COUNT] = {
+	TWI_US_BYTE(TWI_SCL_25K), TWI_US_BYTE(TWI_SCL_100K), TWI_US_BYTE(TWI_SCL_400K)
+};
+
+// Velocidade por escravo (registrada pelos drivers no init)
+static uint8_t dev_addr[TWI_MAX_DEVICES];
+static uint8_t dev_speed[TWI_MAX_DEVICES];
+static uint8_t dev_count;
+static uint8_t cur_speed;
+
+static void set_bitrate(uint8_t speed) {
+	cur_speed = speed;
+	TWSR = speed_twps[speed];
+	TWBR = speed_twbr[speed];
+}
+
+static void hw_init(void) {
+	set_bitrate(cur_speed);
 	TWCR = (1<<TWEN);
 }
 
-uint8_t twi_start(void) {
-	TWCR = (1<<TWINT)|(1<<TWSTA)|(1<<TWEN);
-	while(!(TWCR & (1<<TWINT)));
-	return (TWSR & 0xF8);
+void twi_init(void) {
+	cur_speed = TWI_SPEED_25K;
+	hw_init();
+	q_head = q_count = 0;
+}
+
+uint8_t twi_set_speed(uint8_t addr, twi_speed_t speed) {
+	for (uint8_t i = 0; i < dev_count; i++) {
+		if (dev_addr[i] == addr) { dev_speed[i] = speed; return 1; }
+	}
+	if (dev_count == TWI_MAX_DEVICES) return 0;
+	dev_addr[dev_count] = addr;
+	dev_speed[dev_count++] = speed;
+	return 1;
+}
+
+static uint8_t speed_of(uint8_t addr) {
+	for (uint8_t i = 0; i < dev_count; i++)
+		if (dev_addr[i] == addr) return dev_speed[i];
+	return TWI_SPEED_25K;
+}
+
+void twi_bus_clear(void) {
+	TWCR = 0;                                   // devolve SDA/SCL ao PORTC
+	PORTC &= ~((1<<TWI_SDA) | (1<<TWI_SCL));    // dreno aberto: DDR=1 puxa para 0
+	DDRC  &= ~((1<<TWI_SDA) | (1<<TWI_SCL));    // soltos (pull-ups externos)
+
+	// At 9 pulsos de SCL para o escravo terminar o byte e soltar o SDA
+	for (uint8_t i = 0; i < 9 && !(PINC & (1<<TWI_SDA)); i++) {
+		DDRC |=  (1<<TWI_SCL); _delay_us(TWI_CLEAR_HALF_US);
+		DDRC &= ~(1<<TWI_SCL); _delay_us(TWI_CLEAR_HALF_US);
+	}
+
+	// STOP manual: SDA sobe com SCL alto
+	DDRC |=  (1<<TWI_SCL); _delay_us(TWI_CLEAR_HALF_US);
+	DDRC |=  (1<<TWI_SDA); _delay_us(TWI_CLEAR_HALF_US);
+	DDRC &= ~(1<<TWI_SCL); _delay_us(TWI_CLEAR_HALF_US);
+	DDRC &= ~(1<<TWI_SDA); _delay_us(TWI_CLEAR_HALF_US);
+
+	hw_init();
+}
+
+// Prepara a transao na cabea da fila (chamada com interrupes desligadas)
+static void load_head(void) {
+	twi_xfer_t *x = queue[q_head];
+	pos = 0;
+	reading = (x->wlen == 0);
+	if (x->timeout_ms) {
+		ticks_left = x->timeout_ms;
+	} else {
+		ticks_left = TWI_BUDGET_MS(x->wlen + x->rlen, speed_us_byte[x->speed]);
+	}
+	if (x->speed != cur_speed) set_bitrate(x->speed);
+	x->status = TWI_BUSY;
+}
+
+// Gera START para a transao na cabea da fila
+static void kick(void) {
+	uint8_t spin = TWI_STOP_SPIN;
+	while ((TWCR & (1<<TWSTO)) && --spin)   // STOP anterior ainda em curso
+		_delay_us(10);
+	if (!spin) twi_bus_clear();             // SCL preso: STOP nunca saiu
+
+	load_head();
+	deadline_start();
+	TWCR = TWCR_GO | (1<<TWSTA);
+}
+
+// Retira a transao corrente da fila
+static twi_xfer_t *dequeue(void) {
+	twi_xfer_t *x = queue[q_head];
+	q_head = (q_head + 1) & (TWI_QUEUE_LEN - 1);
+	q_count--;
+	return x;
+}
+
+#if TWI_STATS
+static twi_stats_t stats;
+
+void twi_stats_get(twi_stats_t *out) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { *out = stats; }
+}
+
+void twi_stats_reset(void) {
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		stats.xfers = stats.errors = 0;
+		stats.bytes = stats.bus_us = 0;
+	}
+}
+
+// Conta a transao como se tivesse ido at o fim (SLA+R s se houver leitura)
+static void account(twi_xfer_t *x, twi_status_t status) {
+	uint16_t n = x->wlen + x->rlen + 1 + (x->wlen && x->rlen);
+	stats.xfers++;
+	if (status != TWI_OK) stats.errors++;
+	stats.bytes += n;
+	stats.bus_us += (uint32_t)n * speed_us_byte[x->speed];
+}
+#endif
+
+static void notify(twi_xfer_t *x, twi_status_t status) {
+#if TWI_STATS
+	account(x, status);
+#endif
+	x->status = status;
+	if (x->done) x->done(x);
+}
+
+// Encerra a transao corrente com STOP e emenda a prxima (STOP + START) se houver
+static void finish(twi_status_t status) {
+	twi_xfer_t *x = dequeue();
+	if (q_count) {
+		load_head();                            // prazo da prxima comea agora
+		TWCR = TWCR_GO | (1<<TWSTO) | (1<<TWSTA);
+	} else {
+		deadline_stop();
+		TWCR = (1<<TWINT) | (1<<TWEN) | (1<<TWSTO);
+	}
+	notify(x, status);
+}
+
+ISR(TWI_vect) {
+	twi_xfer_t *x = queue[q_head];
+
+	switch (TW_STATUS) {
+	case TW_START:
+	case TW_REP_START:
+		TWDR = (x->addr << 1) | (reading ? TW_READ : TW_WRITE);
+		TWCR = TWCR_GO;
+		break;
+
+	case TW_MT_SLA_ACK:
+	case TW_MT_DATA_ACK:
+		if (pos < x->wlen) {
+			TWDR = x->wbuf[pos++];
+			TWCR = TWCR_GO;
+		} else if (x->rlen) {
+			reading = 1;                     // repeated START para a leitura
+			pos = 0;
+			TWCR = TWCR_GO | (1<<TWSTA);
+		} else {
+			finish(TWI_OK);
+		}
+		break;
+
+	case TW_MR_SLA_ACK:
+		if (x->rlen == 0) { finish(TWI_OK); break; }
+		TWCR = TWCR_GO | (x->rlen > 1 ? (1<<TWEA) : 0);
+		break;
+
+	case TW_MR_DATA_ACK:
+		x->rbuf[pos++] = TWDR;
+		TWCR = TWCR_GO | (pos + 1 < x->rlen ? (1<<TWEA) : 0);  // ltimo byte com NACK
+		break;
+
+	case TW_MR_DATA_NACK:
+		x->rbuf[pos++] = TWDR;
+		finish(TWI_OK);
+		break;
+
+	case TW_MT_SLA_NACK:
+	case TW_MT_DATA_NACK:
+	case TW_MR_SLA_NACK:
+		finish(TWI_NACK);
+		break;
+
+	case TW_MT_ARB_LOST:                     // = TW_MR_ARB_LOST
+		finish(TWI_ARB_LOST);
+		break;
+
+	default:                                 // TW_BUS_ERROR e estados inesperados
+		finish(TWI_BUS_ERROR);
+		break;
+	}
+}
+
+// Prazo estourado: escravo segurando SDA/SCL ou ISR que nunca veio
+ISR(TIMER0_COMPA_vect) {
+	if (!q_count) { deadline_stop(); return; }
+	if (--ticks_left) return;
+
+	twi_bus_clear();
+	twi_xfer_t *x = dequeue();
+	if (q_count) {
+		load_head();
+		TWCR = TWCR_GO | (1<<TWSTA);
+	} else {
+		deadline_stop();
+	}
+	notify(x, TWI_TIMEOUT);
+}
+
+uint8_t twi_submit(twi_xfer_t *x) {
+	uint8_t ok = 0;
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+		if (q_count < TWI_QUEUE_LEN) {
+			x->status = TWI_QUEUED;
+			x->speed = speed_of(x->addr);
+			queue[(q_head + q_count) & (TWI_QUEUE_LEN - 1)] = x;
+			if (q_count++ == 0) kick();
+			ok = 1;
+		}
+	}
+	return ok;
 }
 
-void twi_stop(void) {
-	TWCR = (1<<TWINT)|(1<<TWSTO)|(1<<TWEN);
-	while(TWCR & (1<<TWSTO));
+twi_status_t twi_wait(twi_xfer_t *x) {
+	set_sleep_mode(SLEEP_MODE_IDLE);         // TWI e Timer0 continuam ativos em idle
+	cli();
+	while (x->status >= TWI_QUEUED) {
+		sleep_enable();
+		sei();                               // sei + sleep: sem janela para perder a ISR
+		sleep_cpu();
+		sleep_disable();
+		cli();
+	}
+	sei();
+	return x->status;
 }
 
-void twi_write(uint8_t data) {
-	TWDR = data;
-	TWCR = (1<<TWINT)|(1<<TWEN);
-	while(!(TWCR & (1<<TWINT)));
+twi_status_t twi_transfer(uint8_t addr, const uint8_t *wbuf, uint8_t wlen,
+                          uint8_t *rbuf, uint8_t rlen) {
+	twi_xfer_t x = { addr, wbuf, wlen, rbuf, rlen, 0, 0, 0, TWI_OK };
+	while (!twi_submit(&x));                 // fila cheia: ISR/prazo liberam espao
+	return twi_wait(&x);
 }
 
-uint8_t twi_read_ack(void) {
-	TWCR = (1<<TWINT)|(1<<TWEN)|(1<<TWEA);
-	while(!(TWCR & (1<<TWINT)));
-	return TWDR;
+twi_status_t twi_read_regs(uint8_t addr, uint8_t reg, uint8_t *buf, uint8_t n) {
+	return twi_transfer(addr, &reg, 1, buf, n);
 }
 
-uint8_t twi_read_nack(void) {
-	TWCR = (1<<TWINT)|(1<<TWEN);
-	while(!(TWCR & (1<<TWINT)));
-	return TWDR;
+twi_status_t twi_write_regs(uint8_t addr, uint8_t reg, const uint8_t *buf, uint8_t n) {
+	uint8_t b[1 + TWI_WRITE_REGS_MAX];      // registrador + dados numa s fase de escrita
+	if (n > TWI_WRITE_REGS_MAX) return TWI_ARG_ERROR;
+	b[0] = reg;
+	for (uint8_t i = 0; i < n; i++) b[i + 1] = buf[i];
+	return twi_transfer(addr, b, n + 1, 0, 0);
 }
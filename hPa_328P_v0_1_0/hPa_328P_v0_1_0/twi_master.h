@@ -8,16 +8,130 @@
 #define F_CPU 1000000UL
 #endif
 
-// 100 kHz em F_CPU = 8 MHz ? TWBR = 32 (aprox), prescaler = 1
-#define F_SCL      100000UL
-#define TWI_PRESC  1
-#define TWBR_VAL   (uint8_t)((F_CPU / F_SCL - 16) / (2 * TWI_PRESC))
+// Tamanho da fila de transaes (potncia de 2)
+#define TWI_QUEUE_LEN 4
+
+// =============== Perfis de velocidade do SCL ===============
+// SCL = F_CPU / (16 + 2 * TWBR * 4^TWPS). Tudo  calculado em tempo de
+// compilao a partir do F_CPU; perfis acima do que o clock permite so
+// limitados a TWI_SCL_MAX (ex.: a 1 MHz todos ficam em ~25-28 kHz).
+#define TWI_SCL_25K    25000UL
+#define TWI_SCL_100K  100000UL
+#define TWI_SCL_400K  400000UL
+
+#define TWI_TWBR_MIN  10         // menor TWBR recomendado no modo mestre
+#define TWI_SCL_MAX   (F_CPU / (16 + 2UL * TWI_TWBR_MIN))
+
+#define TWI_SCL_CLAMP(scl)  ((scl) < TWI_SCL_MAX ? (scl) : TWI_SCL_MAX)
+#define TWI_DIV(scl)        ((F_CPU / TWI_SCL_CLAMP(scl) - 16) / 2)   // TWBR * 4^TWPS
+#define TWI_TWPS(scl)       (TWI_DIV(scl) <= 255UL ? 0 : TWI_DIV(scl) <= 1020UL ? 1 : \
+                             TWI_DIV(scl) <= 4080UL ? 2 : 3)
+#define TWI_TWBR(scl)       ((uint8_t)(TWI_DIV(scl) >> (2 * TWI_TWPS(scl))))
+#define TWI_SCL_REAL(scl)   (F_CPU / (16 + 2UL * TWI_TWBR(scl) * (1UL << (2 * TWI_TWPS(scl)))))
+
+#if TWI_SCL_MAX < TWI_SCL_25K
+#error "F_CPU baixo demais: nem o perfil de 25 kHz  possvel no TWI"
+#endif
+#if ((F_CPU / TWI_SCL_25K - 16) / 2) > (255UL * 64)
+#error "F_CPU alto demais: 25 kHz exige TWBR > 255 mesmo com prescaler 64"
+#endif
+
+typedef enum {
+	TWI_SPEED_25K = 0,   // padro para endereos no registrados
+	TWI_SPEED_100K,      // PCF8574, DS1307
+	TWI_SPEED_400K,      // BMP180/BMP280
+	TWI_SPEED_COUNT
+} twi_speed_t;
+
+// Quantos escravos podem ter velocidade prpria (twi_set_speed)
+#define TWI_MAX_DEVICES 4
+
+// Tempo de um byte no barramento (9 bits) no perfil scl, em us
+#define TWI_US_BYTE(scl)    (9000000UL / TWI_SCL_REAL(scl))
+
+// Prazo automtico em ms: 2x o tempo de bits (+2 bytes de endereo) + 2 ms.
+// Em 16 bits: a 1 MHz (~28 kHz) 255 + 255 bytes do ~335 ms.
+#define TWI_BUDGET_MS(nbytes, us_byte) \
+	((uint16_t)(((nbytes) + 2UL) * (us_byte) / 500 + 2))
+
+// Pinos soltos por este tempo em cada meio perodo do bus clear
+#define TWI_CLEAR_HALF_US   20
+
+// Resultado de uma transao (campo status)
+typedef enum {
+	TWI_OK = 0,        // concluda com sucesso
+	TWI_NACK,          // escravo no respondeu (endereo ou dado)
+	TWI_ARB_LOST,      // perda de arbitragem
+	TWI_BUS_ERROR,     // START/STOP ilegal detectado pelo hardware
+	TWI_TIMEOUT,       // prazo estourado; barramento foi limpo e reiniciado
+	TWI_ARG_ERROR,     // pedido invlido do chamador; nada foi ao barramento
+	TWI_DATA_ERROR,    // transao OK, mas o dado do sensor no serve (descartar)
+	TWI_QUEUED,        // aguardando na fila
+	TWI_BUSY           // em andamento no barramento
+} twi_status_t;
+
+typedef struct twi_xfer {
+	uint8_t addr;                        // endereo de 7 bits do escravo
+	const uint8_t *wbuf;                 // bytes a enviar
+	uint8_t wlen;
+	uint8_t *rbuf;                       // destino dos bytes lidos
+	uint8_t rlen;
+	uint8_t timeout_ms;                  // prazo (0 = automtico: TWI_BUDGET_MS no perfil)
+	uint8_t speed;                       // twi_speed_t, preenchido por twi_submit()
+	void (*done)(struct twi_xfer *x);    // chamado na ISR ao terminar (ou NULL)
+	volatile twi_status_t status;
+} twi_xfer_t;
 
 void twi_init(void);
-uint8_t twi_start(void);
-void twi_stop(void);
-void twi_write(uint8_t data);
-uint8_t twi_read_ack(void);
-uint8_t twi_read_nack(void);
+
+// Define o perfil de SCL usado nas transaes para o escravo addr
+// (limitado ao que o F_CPU permite). Retorna 0 se a tabela estiver cheia.
+uint8_t twi_set_speed(uint8_t addr, twi_speed_t speed);
+
+// Libera um escravo preso (9 pulsos de SCL + STOP) e reinicia o TWI
+void twi_bus_clear(void);
+
+// Coloca a transao na fila e retorna imediatamente (0 = fila cheia).
+// O buffer e a prpria estrutura devem continuar vlidos at o fim.
+uint8_t twi_submit(twi_xfer_t *x);
+
+// Dorme em SLEEP_MODE_IDLE at a transao terminar; retorna o status final.
+// Nunca bloqueia mais que o prazo da transao (e das que esto  frente):
+// TWI_BUDGET_MS (ou timeout_ms) + o bus clear, 22 x TWI_CLEAR_HALF_US.
+twi_status_t twi_wait(twi_xfer_t *x);
+
+// Atalho bloqueante: monta, enfileira e espera uma transao
+twi_status_t twi_transfer(uint8_t addr, const uint8_t *wbuf, uint8_t wlen,
+                     uint8_t *rbuf, uint8_t rlen);
+
+// =============== Contabilidade do barramento (opcional) ===============
+// Com TWI_STATS = 1 o motor conta transaes, bytes e tempo de barramento
+// estimado (bits x perodo do perfil), para medir o custo de cada chamada
+// de driver em Proteus ou na placa: zere, chame o driver, leia os contadores.
+#ifndef TWI_STATS
+#define TWI_STATS 0
+#endif
+
+#if TWI_STATS
+typedef struct {
+	uint16_t xfers;      // transaes concludas (inclui erros)
+	uint16_t errors;     // transaes com status != TWI_OK
+	uint32_t bytes;      // bytes no barramento, incluindo SLA+W/SLA+R
+	uint32_t bus_us;     // tempo de barramento estimado em us
+} twi_stats_t;
+
+void twi_stats_get(twi_stats_t *out);
+void twi_stats_reset(void);
+#endif
+
+// Leitura em bloco: SLA+W, reg, repeated START, SLA+R, n bytes, STOP
+twi_status_t twi_read_regs(uint8_t addr, uint8_t reg, uint8_t *buf, uint8_t n);
+
+// Escrita em bloco: SLA+W, reg, n bytes, STOP. O registrador e os dados
+// vo juntos num buffer na pilha, por isso n <= TWI_WRITE_REGS_MAX; acima
+// disso  erro de programao: TWI_ARG_ERROR, sem tocar no barramento
+// (no adianta repetir nem limpar o bus).
+#define TWI_WRITE_REGS_MAX 8
+twi_status_t twi_write_regs(uint8_t addr, uint8_t reg, const uint8_t *buf, uint8_t n);
 
 #endif
@@ -0,0 +1,20 @@
+// Memria que no AVR  hardware: registradores de E/S e EEPROM
+#include <avr/io.h>
+#include <avr/eeprom.h>
+#include <string.h>
+
+volatile uint8_t host_io[256];
+
+uint32_t host_eeprom_writes;
+
+void eeprom_read_block(void *dst, const void *src, size_t n) {
+	memcpy(dst, src, n);
+}
+
+void eeprom_update_block(const void *src, void *dst, size_t n) {
+	const uint8_t *s = src;
+	uint8_t *d = dst;
+	for (size_t i = 0; i < n; i++) {
+		if (d[i] != s[i]) { d[i] = s[i]; host_eeprom_writes++; }
+	}
+}
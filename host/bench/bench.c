@@ -0,0 +1,327 @@
+// Banco de medida do firmware no simavr: roda o ELF compilado com
+// PROFILE = 1 (prof.h) num ATmega328P a 1 MHz com os mesmos modelos de
+// chips dos testes (models/) ligados ao TWI, o SQW do DS1307 no PD2, o
+// LM35 no ADC0 e o boto solto. Cada escrita em GPIOR0 fecha a fase
+// anterior; o gancho de sono do simavr separa, dentro de cada fase, os
+// ciclos acordado, em IDLE/ADC e em power-down. A carga  estimada com as
+// correntes tpicas do datasheet (s o MCU; sensores, LCD e LEDs fora).
+//
+//   bench [-t segundos] [-o prefixo] [-b bmp180|bmp280] firmware.elf
+//
+// Escreve prefixo.csv (uma linha por fase) e prefixo.json (fases + totais)
+// para acompanhar regresses entre commits.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "sim_avr.h"
+#include "sim_elf.h"
+#include "sim_io.h"
+#include "sim_time.h"
+#include "avr_twi.h"
+#include "avr_ioport.h"
+#include "avr_adc.h"
+
+#include "sim.h"
+#include "i2c_dev.h"
+#include "bmp180_model.h"
+#include "bmp280_model.h"
+#include "ds1307_model.h"
+#include "lcd_model.h"
+
+#define BENCH_F_CPU    1000000UL
+#define BENCH_VCC_MV   5000
+
+// Registradores (endereo na memria de dados do ATmega328P)
+#define REG_GPIOR0     0x3E
+#define REG_SMCR       0x53
+#define REG_ADCSRA     0x7A
+#define SMCR_SE        0x01
+#define ADCSRA_ADEN    0x80
+#define ADCSRA_ADSC    0x40
+
+// Modos de sono (SM2:0) agrupados pelo consumo
+enum { PWR_ACTIVE, PWR_IDLE, PWR_ADC, PWR_DOWN, PWR_COUNT };
+
+// Correntes tpicas do ATmega328P a 5 V, 1 MHz, em uA (datasheet, tabela
+// 28-x e curvas de consumo; ativo e idle escalados de 8 MHz para 1 MHz)
+static double current_ua[PWR_COUNT] = {
+	650.0,     // ativo
+	150.0,     // idle
+	400.0,     // ADC noise reduction: idle sem clk_IO + ADC ligado
+	6.5,       // power-down com WDT
+};
+static const char *pwr_name[PWR_COUNT] = { "active", "idle", "adc", "pwrdown" };
+
+// Ids gravados em GPIOR0 pelo PROF_MARK() (prof.h); 0 = antes do 1 marcador
+#define PHASES     8
+#define PH_AWAKE   1
+static const char *phase_name[PHASES] = {
+	"boot", "awake", "baro", "adc", "lcd", "alert", "sleep", "bmp180_comp"
+};
+
+typedef struct {
+	avr_cycle_count_t cycles[PWR_COUNT];   // [PWR_ACTIVE] = total at o fechamento
+	uint32_t entries;
+} phase_t;
+
+static avr_t *avr;
+static phase_t phase[PHASES];
+static uint8_t cur_phase;
+static avr_cycle_count_t phase_start;
+static avr_cycle_count_t phase_sleep[PWR_COUNT];
+
+// =============== Relgio dos modelos ===============
+// D a volta a cada ~71 min; os modelos s comparam diferenas
+uint32_t sim_now_us(void) {
+	return (uint32_t)avr_cycles_to_usec(avr, avr->cycle);
+}
+
+void sim_advance_us(uint32_t us) {
+	(void)us;                                    // o tempo  o do simavr
+}
+
+// =============== Fases (GPIOR0) ===============
+static void close_phase(void) {
+	phase_t *p = &phase[cur_phase];
+	avr_cycle_count_t total = avr->cycle - phase_start;
+	avr_cycle_count_t slept = 0;
+	for (int i = PWR_IDLE; i < PWR_COUNT; i++) {
+		p->cycles[i] += phase_sleep[i];
+		slept += phase_sleep[i];
+		phase_sleep[i] = 0;
+	}
+	p->cycles[PWR_ACTIVE] += total > slept ? total - slept : 0;
+	phase_start = avr->cycle;
+}
+
+static void on_gpior0(avr_t *a, avr_io_addr_t addr, uint8_t v, void *param) {
+	(void)param;
+	a->data[addr] = v;
+	close_phase();
+	cur_phase = v < PHASES ? v : 0;
+	phase[cur_phase].entries++;
+}
+
+// =============== Sono ===============
+static int sleep_kind(void) {
+	switch ((avr->data[REG_SMCR] >> 1) & 0x07) {
+	case 0:  return PWR_IDLE;
+	case 1:  return PWR_ADC;
+	default: return PWR_DOWN;                    // power-down/save, standby
+	}
+}
+
+// Chamado pelo ncleo a cada trecho dormido; substitui o padro, que
+// sincroniza com o relgio de parede
+static void on_sleep(avr_t *a, avr_cycle_count_t how_long) {
+	(void)a;
+	phase_sleep[sleep_kind()] += how_long + 1;
+}
+
+// Entrar em SLEEP_MODE_ADC com o ADC ligado dispara a converso no
+// hardware; o simavr no faz isso, ento o banco faz ao ver o SE
+static void on_smcr(avr_t *a, avr_io_addr_t addr, uint8_t v, void *param) {
+	(void)param;
+	a->data[addr] = v;
+	uint8_t adcsra = a->data[REG_ADCSRA];
+	if ((v & SMCR_SE) && ((v >> 1) & 0x07) == 1 &&
+	    (adcsra & ADCSRA_ADEN) && !(adcsra & ADCSRA_ADSC)) {
+		avr_io_addr_t io = AVR_DATA_TO_IO(REG_ADCSRA);
+		if (a->io[io].w.c)
+			a->io[io].w.c(a, REG_ADCSRA, adcsra | ADCSRA_ADSC, a->io[io].w.param);
+	}
+}
+
+// =============== Ponte TWI -> modelos ===============
+static avr_irq_t *twi_irq;
+static i2c_dev_t *selected;
+
+static void twi_reply(uint8_t msg, uint8_t addr, uint8_t data) {
+	avr_raise_irq(twi_irq + TWI_IRQ_INPUT, avr_twi_irq_msg(msg, addr, data));
+}
+
+static void on_twi(avr_irq_t *irq, uint32_t value, void *param) {
+	(void)irq; (void)param;
+	avr_twi_msg_irq_t v;
+	v.u.v = value;
+
+	if (v.u.twi.msg & TWI_COND_STOP) {
+		if (selected) selected->stop(selected);
+		selected = NULL;
+	}
+	if (v.u.twi.msg & TWI_COND_START) {          // START ou repeated START + SLA
+		selected = i2c_bus_find(v.u.twi.addr >> 1);
+		if (selected) {
+			selected->start(selected, v.u.twi.addr & 1);
+			twi_reply(TWI_COND_ACK, v.u.twi.addr, 1);
+		}
+	}
+	if (!selected) return;
+	if (v.u.twi.msg & TWI_COND_WRITE) {
+		if (selected->write(selected, v.u.twi.data))
+			twi_reply(TWI_COND_ACK, v.u.twi.addr, 1);
+	}
+	if (v.u.twi.msg & TWI_COND_READ) {
+		uint8_t d = selected->read(selected, !!(v.u.twi.msg & TWI_COND_ACK));
+		twi_reply(TWI_COND_READ, v.u.twi.addr, d);
+	}
+}
+
+static void twi_attach(void) {
+	twi_irq = avr_alloc_irq(&avr->irq_pool, 0, 2, NULL);
+	avr_connect_irq(twi_irq + TWI_IRQ_INPUT,
+	                avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_INPUT));
+	avr_connect_irq(avr_io_getirq(avr, AVR_IOCTL_TWI_GETIRQ(0), TWI_IRQ_OUTPUT),
+	                twi_irq + TWI_IRQ_OUTPUT);
+	avr_irq_register_notify(twi_irq + TWI_IRQ_OUTPUT, on_twi, NULL);
+}
+
+// =============== SQW do DS1307 no PD2 ===============
+static ds1307_model_t rtc;
+static uint8_t sqw_level = 2;
+
+#define SQW_SAMPLE_US  10000
+
+static avr_cycle_count_t on_sqw(avr_t *a, avr_cycle_count_t when, void *param) {
+	(void)param;
+	uint8_t l = ds1307_model_sqw(&rtc);
+	if (l != sqw_level) {
+		sqw_level = l;
+		avr_raise_irq(avr_io_getirq(a, AVR_IOCTL_IOPORT_GETIRQ('D'), 2), l);
+	}
+	return when + avr_usec_to_cycles(a, SQW_SAMPLE_US);
+}
+
+// =============== Relatrio ===============
+static double charge_uc(const phase_t *p) {
+	double q = 0;
+	for (int i = 0; i < PWR_COUNT; i++)
+		q += current_ua[i] * (double)p->cycles[i] / BENCH_F_CPU;   // uA * s = uC
+	return q;
+}
+
+static avr_cycle_count_t phase_total(const phase_t *p) {
+	avr_cycle_count_t t = 0;
+	for (int i = 0; i < PWR_COUNT; i++) t += p->cycles[i];
+	return t;
+}
+
+static void report(const char *prefix, double seconds) {
+	char path[512];
+	uint32_t iters = phase[PH_AWAKE].entries ? phase[PH_AWAKE].entries : 1;
+	phase_t all;
+	memset(&all, 0, sizeof(all));
+	for (int f = 0; f < PHASES; f++)
+		for (int i = 0; i < PWR_COUNT; i++) all.cycles[i] += phase[f].cycles[i];
+	avr_cycle_count_t awake = all.cycles[PWR_ACTIVE];
+	avr_cycle_count_t asleep = phase_total(&all) - awake;
+
+	snprintf(path, sizeof(path), "%s.csv", prefix);
+	FILE *csv = fopen(path, "w");
+	snprintf(path, sizeof(path), "%s.json", prefix);
+	FILE *js = fopen(path, "w");
+	if (!csv || !js) { perror(prefix); exit(1); }
+
+	fprintf(csv, "phase,entries,cycles,active,idle,adc,pwrdown,cycles_per_iter,charge_uC\n");
+	fprintf(js, "{\n  \"seconds\": %.3f,\n  \"f_cpu\": %lu,\n  \"iterations\": %u,\n  \"phases\": {\n",
+	        seconds, BENCH_F_CPU, iters);
+	printf("%-12s %7s %12s %12s %12s %10s\n", "fase", "vezes", "ciclos", "acordado", "ciclos/iter", "carga uC");
+	for (int f = 0; f < PHASES; f++) {
+		const phase_t *p = &phase[f];
+		avr_cycle_count_t t = phase_total(p);
+		fprintf(csv, "%s,%u,%llu,%llu,%llu,%llu,%llu,%.1f,%.3f\n", phase_name[f], p->entries,
+		        (unsigned long long)t, (unsigned long long)p->cycles[PWR_ACTIVE],
+		        (unsigned long long)p->cycles[PWR_IDLE], (unsigned long long)p->cycles[PWR_ADC],
+		        (unsigned long long)p->cycles[PWR_DOWN], (double)t / iters, charge_uc(p));
+		fprintf(js, "    \"%s\": { \"entries\": %u, \"cycles\": %llu", phase_name[f], p->entries,
+		        (unsigned long long)t);
+		for (int i = 0; i < PWR_COUNT; i++)
+			fprintf(js, ", \"%s\": %llu", pwr_name[i], (unsigned long long)p->cycles[i]);
+		fprintf(js, ", \"charge_uC\": %.3f }%s\n", charge_uc(p), f + 1 < PHASES ? "," : "");
+		printf("%-12s %7u %12llu %12llu %12.1f %10.3f\n", phase_name[f], p->entries,
+		       (unsigned long long)t, (unsigned long long)p->cycles[PWR_ACTIVE],
+		       (double)t / iters, charge_uc(p));
+	}
+	double q = charge_uc(&all);
+	fprintf(js, "  },\n  \"awake_cycles\": %llu,\n  \"asleep_cycles\": %llu,\n"
+	        "  \"awake_ratio\": %.6f,\n  \"charge_uC\": %.3f,\n  \"charge_per_iter_uC\": %.3f,\n"
+	        "  \"avg_current_uA\": %.3f\n}\n",
+	        (unsigned long long)awake, (unsigned long long)asleep,
+	        asleep ? (double)awake / asleep : 0.0, q, q / iters, q / seconds);
+	printf("acordado/dormindo = %.6f, carga %.3f uC (%.3f uC/iterao), mdia %.2f uA\n",
+	       asleep ? (double)awake / asleep : 0.0, q, q / iters, q / seconds);
+	fclose(csv);
+	fclose(js);
+}
+
+static void usage(const char *argv0) {
+	fprintf(stderr, "uso: %s [-t segundos] [-o prefixo] [-b bmp180|bmp280] firmware.elf\n", argv0);
+	exit(2);
+}
+
+int main(int argc, char **argv) {
+	double seconds = 600;
+	const char *prefix = "bench";
+	int use_bmp280 = 0;
+	int opt;
+	while ((opt = getopt(argc, argv, "t:o:b:")) != -1) {
+		switch (opt) {
+		case 't': seconds = atof(optarg); break;
+		case 'o': prefix = optarg; break;
+		case 'b': use_bmp280 = !strcmp(optarg, "bmp280"); break;
+		default:  usage(argv[0]);
+		}
+	}
+	if (optind >= argc) usage(argv[0]);
+
+	elf_firmware_t fw;
+	memset(&fw, 0, sizeof(fw));
+	if (elf_read_firmware(argv[optind], &fw)) {
+		fprintf(stderr, "%s: no consegui ler o ELF\n", argv[optind]);
+		return 1;
+	}
+	strcpy(fw.mmcu, "atmega328p");
+	fw.frequency = BENCH_F_CPU;
+	fw.vcc = fw.avcc = BENCH_VCC_MV;
+
+	avr = avr_make_mcu_by_name(fw.mmcu);
+	if (!avr) { fprintf(stderr, "simavr sem atmega328p\n"); return 1; }
+	avr_init(avr);
+	avr_load_firmware(avr, &fw);
+	avr->sleep = on_sleep;
+
+	avr_register_io_write(avr, REG_GPIOR0, on_gpior0, NULL);
+	avr_register_io_write(avr, REG_SMCR, on_smcr, NULL);
+
+	// Escravos no barramento
+	static bmp180_model_t bmp180;
+	static bmp280_model_t bmp280;
+	static lcd_model_t lcd;
+	i2c_bus_reset();
+	if (use_bmp280) { bmp280_model_init(&bmp280); i2c_bus_attach(&bmp280.dev); }
+	else            { bmp180_model_init(&bmp180); i2c_bus_attach(&bmp180.dev); }
+	ds1307_model_init(&rtc);
+	i2c_bus_attach(&rtc.dev);
+	lcd_model_init(&lcd);
+	i2c_bus_attach(&lcd.dev);
+	twi_attach();
+
+	// Pinos externos: boto solto (PB2 em 1), LM35 a 25 C, SQW do RTC
+	avr_raise_irq(avr_io_getirq(avr, AVR_IOCTL_IOPORT_GETIRQ('B'), 2), 1);
+	avr_raise_irq(avr_io_getirq(avr, AVR_IOCTL_ADC_GETIRQ, ADC_IRQ_ADC0), 250);
+	avr_cycle_timer_register_usec(avr, SQW_SAMPLE_US, on_sqw, NULL);
+
+	// Em ciclos (64 bits) direto: em s de 32 bits passaria de ~4295 s
+	avr_cycle_count_t end = (avr_cycle_count_t)(seconds * BENCH_F_CPU);
+	int state = cpu_Running;
+	while (avr->cycle < end && state != cpu_Done && state != cpu_Crashed)
+		state = avr_run(avr);
+	close_phase();
+	if (state == cpu_Crashed) fprintf(stderr, "firmware travou no ciclo %llu\n",
+	                                  (unsigned long long)avr->cycle);
+
+	report(prefix, (double)avr->cycle / BENCH_F_CPU);
+	return state == cpu_Crashed;
+}
@@ -0,0 +1,15 @@
+// Shim de <avr/eeprom.h>: variveis EEMEM ficam na RAM do processo (valem
+// enquanto ele roda); as gravaes so contadas para os relatrios
+#ifndef HOST_AVR_EEPROM_H
+#define HOST_AVR_EEPROM_H
+#include <stdint.h>
+#include <stddef.h>
+
+#define EEMEM
+
+extern uint32_t host_eeprom_writes;     // bytes efetivamente regravados
+
+void eeprom_read_block(void *dst, const void *src, size_t n);
+void eeprom_update_block(const void *src, void *dst, size_t n);
+
+#endif
@@ -0,0 +1,22 @@
+// Shim de <avr/io.h> para o build no host: os registradores viram bytes
+// comuns (s os que os drivers compilados aqui tocam)
+#ifndef HOST_AVR_IO_H
+#define HOST_AVR_IO_H
+#include <stdint.h>
+
+extern volatile uint8_t host_io[256];
+
+#define PORTB  host_io[0x25]
+#define DDRB   host_io[0x24]
+#define PINB   host_io[0x23]
+#define PORTC  host_io[0x28]
+#define DDRC   host_io[0x27]
+#define PINC   host_io[0x26]
+#define PORTD  host_io[0x2B]
+#define DDRD   host_io[0x2A]
+#define PIND   host_io[0x29]
+#define GPIOR0 host_io[0x3E]
+
+#define _BV(b) (1 << (b))
+
+#endif
@@ -0,0 +1,9 @@
+// Shim de <util/delay.h>: as esperas avanam o relgio simulado
+#ifndef HOST_UTIL_DELAY_H
+#define HOST_UTIL_DELAY_H
+#include "sim.h"
+
+#define _delay_us(us)  sim_advance_us((uint32_t)(us))
+#define _delay_ms(ms)  sim_advance_us((uint32_t)((ms) * 1000UL))
+
+#endif
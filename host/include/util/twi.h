@@ -0,0 +1,9 @@
+// Shim de <util/twi.h>: o backend do host no usa os cdigos de status do
+// hardware, s os bits de direo
+#ifndef HOST_UTIL_TWI_H
+#define HOST_UTIL_TWI_H
+
+#define TW_WRITE 0
+#define TW_READ  1
+
+#endif
@@ -0,0 +1,100 @@
+#include "bmp180_model.h"
+#include "sim.h"
+#include <string.h>
+
+static const int16_t ex_calib[11] = {
+	408, -72, -14383, (int16_t)32741, (int16_t)32757, 23153,
+	6190, 4, -32768, -8711, 2868
+};
+
+// Tempo mximo de converso em us (temperatura, presso OSS 0..3)
+static const uint16_t conv_us[5] = { 4500, 4500, 7500, 13500, 25500 };
+
+#define SCO (1 << 5)
+
+static bmp180_model_t *self(i2c_dev_t *d) { return (bmp180_model_t *)d; }
+
+// Converso terminada: resultado nos registradores e Sco em 0
+static void update(bmp180_model_t *m) {
+	if (!(m->reg[0xF4] & SCO) || (int32_t)(sim_now_us() - m->conv_end) < 0) return;
+	m->reg[0xF4] &= ~SCO;
+	if (m->ctrl == 0x2E) {
+		m->reg[0xF6] = m->ut >> 8;
+		m->reg[0xF7] = m->ut & 0xFF;
+		m->reg[0xF8] = 0;
+	} else {
+		uint8_t oss = m->ctrl >> 6;
+		uint32_t v = (m->up0 << oss) << (8 - oss);     // 19 bits alinhados  esquerda
+		m->reg[0xF6] = v >> 16;
+		m->reg[0xF7] = v >> 8;
+		m->reg[0xF8] = v;
+	}
+}
+
+// Estado de power-on (tambm o soft reset): calibrao de fbrica na ROM
+static void reset(bmp180_model_t *m) {
+	memset(m->reg, 0, sizeof(m->reg));
+	bmp180_model_set_calib(m, ex_calib);
+	m->reg[0xD0] = 0x55;
+	m->ptr = 0;
+	m->wr_first = 0;
+	m->ctrl = 0;
+}
+
+static void start(i2c_dev_t *d, uint8_t read) {
+	bmp180_model_t *m = self(d);
+	m->wr_first = !read;
+	update(m);
+}
+
+static uint8_t write(i2c_dev_t *d, uint8_t b) {
+	bmp180_model_t *m = self(d);
+	if (m->wr_first) { m->ptr = b; m->wr_first = 0; return 1; }
+
+	uint8_t r = m->ptr++;
+	if (r == 0xF4) {
+		uint8_t cmd = b & 0x3F, oss = b >> 6;
+		if (cmd == 0x2E || cmd == 0x34) {
+			m->ctrl = b;
+			m->conversions++;
+			m->conv_end = sim_now_us() + conv_us[cmd == 0x2E ? 0 : 1 + oss];
+			m->reg[0xF4] = b | SCO;
+		} else {
+			m->reg[0xF4] = b & ~SCO;
+		}
+	} else if (r == 0xE0) {
+		if (b == 0xB6) reset(m);                           // soft reset
+	} else if (r < 0xAA || r > 0xBF) {
+		if (r != 0xD0) m->reg[r] = b;                      // calibrao e ID so ROM
+	}
+	return 1;
+}
+
+static uint8_t read(i2c_dev_t *d, uint8_t ack) {
+	bmp180_model_t *m = self(d);
+	(void)ack;
+	update(m);
+	return m->reg[m->ptr++];
+}
+
+static void stop(i2c_dev_t *d) { (void)d; }
+
+void bmp180_model_set_calib(bmp180_model_t *m, const int16_t *calib) {
+	for (uint8_t i = 0; i < 11; i++) {
+		m->reg[0xAA + 2 * i] = (uint16_t)calib[i] >> 8;
+		m->reg[0xAB + 2 * i] = (uint16_t)calib[i] & 0xFF;
+	}
+}
+
+void bmp180_model_init(bmp180_model_t *m) {
+	memset(m, 0, sizeof(*m));
+	m->dev.addr = 0x77;
+	m->dev.present = 1;
+	m->dev.start = start;
+	m->dev.write = write;
+	m->dev.read = read;
+	m->dev.stop = stop;
+	reset(m);
+	m->ut = 27898;
+	m->up0 = 23843;
+}
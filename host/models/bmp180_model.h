@@ -0,0 +1,28 @@
+// Modelo do BMP180 (datasheet BST-BMP180-DS000, rev. 2.5): mapa de
+// registradores com ponteiro auto-incrementado, chip ID 0x55, calibrao
+// big-endian em 0xAA..0xBF, converses disparadas em 0xF4 com o bit Sco
+// em 1 pelo tempo mximo do datasheet e resultado em 0xF6..0xF8.
+#ifndef BMP180_MODEL_H
+#define BMP180_MODEL_H
+#include "i2c_dev.h"
+
+typedef struct {
+	i2c_dev_t dev;
+	uint8_t  reg[256];
+	uint8_t  ptr;
+	uint8_t  wr_first;       // prximo byte escrito  o ponteiro
+	uint16_t ut;             // temperatura bruta entregue nas converses
+	uint32_t up0;            // presso bruta em OSS 0 (escalada por 2^oss)
+	uint8_t  ctrl;           // ltimo comando em 0xF4
+	uint32_t conv_end;       // fim da converso em curso (sim_now_us)
+	uint16_t conversions;    // converses iniciadas
+} bmp180_model_t;
+
+// Calibrao, UT e UP do exemplo do datasheet (seo 3.5):
+// 15.0 C e 69964 Pa em OSS 0. Endereo 0x77, presente no barramento.
+void bmp180_model_init(bmp180_model_t *m);
+
+// Troca os 11 coeficientes (AC1..MD, na ordem dos registradores)
+void bmp180_model_set_calib(bmp180_model_t *m, const int16_t *calib);
+
+#endif
@@ -0,0 +1,101 @@
+#include "bmp280_model.h"
+#include "sim.h"
+#include <string.h>
+
+// dig_T1..dig_T3, dig_P1..dig_P9
+static const int32_t ex_calib[12] = {
+	27504, 26435, -1000,
+	36477, -10685, 3024, 2855, 140, -7, 15500, -14600, 6000
+};
+
+#define MEASURING (1 << 3)
+
+static bmp280_model_t *self(i2c_dev_t *d) { return (bmp280_model_t *)d; }
+
+uint32_t bmp280_model_meas_us(uint8_t osrs_t, uint8_t osrs_p) {
+	// 1.25 ms + 2.3 ms por amostra de temperatura + (2.3 ms por amostra
+	// de presso + 0.575 ms); osrs 1..5 = 1, 2, 4, 8, 16 amostras
+	uint32_t us = 1250;
+	if (osrs_t) us += 2300UL << ((osrs_t > 5 ? 5 : osrs_t) - 1);
+	if (osrs_p) us += (2300UL << ((osrs_p > 5 ? 5 : osrs_p) - 1)) + 575;
+	return us;
+}
+
+// Medida terminada: dados nos registradores, measuring em 0, modo sleep
+static void update(bmp280_model_t *m) {
+	if (!m->measuring || (int32_t)(sim_now_us() - m->meas_end) < 0) return;
+	m->measuring = 0;
+	m->reg[0xF3] &= ~MEASURING;
+	m->reg[0xF4] &= ~0x03;
+	m->reg[0xF7] = m->adc_p >> 12;
+	m->reg[0xF8] = m->adc_p >> 4;
+	m->reg[0xF9] = (m->adc_p & 0x0F) << 4;
+	m->reg[0xFA] = m->adc_t >> 12;
+	m->reg[0xFB] = m->adc_t >> 4;
+	m->reg[0xFC] = (m->adc_t & 0x0F) << 4;
+}
+
+static void reset(bmp280_model_t *m) {
+	memset(m->reg, 0, sizeof(m->reg));
+	for (uint8_t i = 0; i < 12; i++) {
+		m->reg[0x88 + 2 * i] = (uint16_t)ex_calib[i] & 0xFF;
+		m->reg[0x89 + 2 * i] = (uint16_t)ex_calib[i] >> 8;
+	}
+	m->reg[0xD0] = 0x58;
+	m->reg[0xF7] = 0x80;            // valores de reset dos dados
+	m->reg[0xFA] = 0x80;
+	m->measuring = 0;
+	m->ptr = 0;
+}
+
+static void start(i2c_dev_t *d, uint8_t read) {
+	bmp280_model_t *m = self(d);
+	m->wr_state = 0;
+	(void)read;
+	update(m);
+}
+
+static uint8_t write(i2c_dev_t *d, uint8_t b) {
+	bmp280_model_t *m = self(d);
+	if (m->wr_state == 0) { m->ptr = b; m->wr_state = 1; return 1; }
+	m->wr_state = 0;
+
+	uint8_t r = m->ptr;
+	if (r == 0xE0) {
+		if (b == 0xB6) reset(m);
+	} else if (r == 0xF4) {
+		m->reg[0xF4] = b;
+		uint8_t mode = b & 0x03;
+		if ((mode == 1 || mode == 2) && !m->measuring) {
+			m->measuring = 1;
+			m->measurements++;
+			m->meas_end = sim_now_us() + bmp280_model_meas_us(b >> 5, (b >> 2) & 0x07);
+			m->reg[0xF3] |= MEASURING;
+		}
+	} else if (r == 0xF5) {
+		m->reg[0xF5] = b & ~0x02;       // bit 1 reservado
+	}
+	return 1;                           // demais registradores: ACK, sem efeito
+}
+
+static uint8_t read(i2c_dev_t *d, uint8_t ack) {
+	bmp280_model_t *m = self(d);
+	(void)ack;
+	update(m);
+	return m->reg[m->ptr++];
+}
+
+static void stop(i2c_dev_t *d) { (void)d; }
+
+void bmp280_model_init(bmp280_model_t *m) {
+	memset(m, 0, sizeof(*m));
+	m->dev.addr = 0x77;
+	m->dev.present = 1;
+	m->dev.start = start;
+	m->dev.write = write;
+	m->dev.read = read;
+	m->dev.stop = stop;
+	reset(m);
+	m->adc_t = 519888;
+	m->adc_p = 415148;
+}
@@ -0,0 +1,29 @@
+// Modelo do BMP280 (datasheet BST-BMP280-DS001, rev. 1.19): chip ID 0x58,
+// calibrao little-endian em 0x88..0x9F, escrita em pares registrador/
+// dado (sem auto-incremento), leitura com auto-incremento. Modo forado em
+// ctrl_meas (0xF4): measuring (bit 3 de 0xF3) fica em 1 pelo t_measure
+// mximo dos oversamplings escolhidos e o modo volta a sleep no fim, com
+// press/temp (20 bits) em 0xF7..0xFC. O modo normal no  modelado.
+#ifndef BMP280_MODEL_H
+#define BMP280_MODEL_H
+#include "i2c_dev.h"
+
+typedef struct {
+	i2c_dev_t dev;
+	uint8_t  reg[256];
+	uint8_t  ptr;
+	uint8_t  wr_state;       // 0 = prximo byte  o ponteiro, 1 = dado
+	uint32_t adc_t, adc_p;   // leituras brutas entregues nas medidas
+	uint32_t meas_end;       // fim da medida em curso (sim_now_us)
+	uint8_t  measuring;
+	uint16_t measurements;   // medidas foradas iniciadas
+} bmp280_model_t;
+
+// Calibrao e leituras do exemplo do datasheet (seo 8.2):
+// 25.08 C e ~100653 Pa. Endereo 0x77, presente no barramento.
+void bmp280_model_init(bmp280_model_t *m);
+
+// t_measure mximo em us para osrs_t/osrs_p (0 = medida desligada)
+uint32_t bmp280_model_meas_us(uint8_t osrs_t, uint8_t osrs_p);
+
+#endif
@@ -0,0 +1,107 @@
+#include "ds1307_model.h"
+#include "sim.h"
+#include <string.h>
+
+#define CH    0x80           // segundos: clock halt
+#define OUT   0x80           // controle: nvel com SQWE = 0
+#define SQWE  0x10
+
+static ds1307_model_t *self(i2c_dev_t *d) { return (ds1307_model_t *)d; }
+
+static uint8_t bcd2dec(uint8_t v) { return (v >> 4) * 10 + (v & 0x0F); }
+static uint8_t dec2bcd(uint8_t v) { return ((v / 10) << 4) | (v % 10); }
+
+static uint8_t month_days(uint8_t month, uint8_t year) {
+	static const uint8_t days[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+	if (month == 2 && year % 4 == 0) return 29;    // 2000..2099
+	return days[(month - 1) % 12];
+}
+
+// Avana um segundo com todos os carries do calendrio
+static void tick(ds1307_model_t *m) {
+	uint8_t s = bcd2dec(m->reg[0] & 0x7F), mi = bcd2dec(m->reg[1]), h = bcd2dec(m->reg[2] & 0x3F);
+	uint8_t wd = m->reg[3] & 0x07, day = bcd2dec(m->reg[4]), mo = bcd2dec(m->reg[5]), y = bcd2dec(m->reg[6]);
+
+	if (++s == 60) {
+		s = 0;
+		if (++mi == 60) {
+			mi = 0;
+			if (++h == 24) {
+				h = 0;
+				wd = wd % 7 + 1;
+				if (++day > month_days(mo, y)) {
+					day = 1;
+					if (++mo > 12) { mo = 1; y = (y + 1) % 100; }
+				}
+			}
+		}
+	}
+	m->reg[0] = dec2bcd(s);
+	m->reg[1] = dec2bcd(mi);
+	m->reg[2] = dec2bcd(h);
+	m->reg[3] = wd;
+	m->reg[4] = dec2bcd(day);
+	m->reg[5] = dec2bcd(mo);
+	m->reg[6] = dec2bcd(y);
+}
+
+// Conta os segundos inteiros passados desde o ltimo acesso
+static void sync(ds1307_model_t *m) {
+	if (m->reg[0] & CH) { m->sec_start = sim_now_us(); return; }
+	while (sim_now_us() - m->sec_start >= 1000000UL) {
+		tick(m);
+		m->sec_start += 1000000UL;
+	}
+}
+
+static void start(i2c_dev_t *d, uint8_t read) {
+	ds1307_model_t *m = self(d);
+	m->wr_first = !read;
+	sync(m);
+}
+
+static uint8_t write(i2c_dev_t *d, uint8_t b) {
+	ds1307_model_t *m = self(d);
+	if (m->wr_first) { m->ptr = b & 0x3F; m->wr_first = 0; return 1; }
+
+	uint8_t r = m->ptr;
+	m->ptr = (m->ptr + 1) & 0x3F;
+	if (r == 0) m->sec_start = sim_now_us();        // escrever os segundos zera o divisor
+	m->reg[r] = b;
+	return 1;
+}
+
+static uint8_t read(i2c_dev_t *d, uint8_t ack) {
+	ds1307_model_t *m = self(d);
+	(void)ack;
+	uint8_t v = m->reg[m->ptr];
+	m->ptr = (m->ptr + 1) & 0x3F;
+	return v;
+}
+
+static void stop(i2c_dev_t *d) { (void)d; }
+
+uint8_t ds1307_model_sqw(ds1307_model_t *m) {
+	uint8_t ctrl = m->reg[7];
+	sync(m);
+	if (!(ctrl & SQWE)) return !!(ctrl & OUT);
+	if ((ctrl & 0x03) || (m->reg[0] & CH)) return 1;  // s 1 Hz modelado
+	return sim_now_us() - m->sec_start < 500000UL;
+}
+
+void ds1307_model_init(ds1307_model_t *m) {
+	memset(m, 0, sizeof(*m));
+	m->dev.addr = 0x68;
+	m->dev.present = 1;
+	m->dev.start = start;
+	m->dev.write = write;
+	m->dev.read = read;
+	m->dev.stop = stop;
+	m->reg[0] = CH;
+	m->reg[3] = 1;
+	m->reg[4] = 0x01;
+	m->reg[5] = 0x01;
+	m->reg[6] = 0x00;
+	m->reg[7] = 0x03;                   // valor de power-on do controle
+	m->sec_start = sim_now_us();
+}
@@ -0,0 +1,24 @@
+// Modelo do DS1307 (datasheet DS1307 rev. 10/2015): 64 registradores com
+// ponteiro auto-incrementado que d a volta em 0x3F -> 0x00, calendrio
+// BCD (s o modo 24 h) contando pelo relgio simulado enquanto CH = 0, RAM
+// em 0x08..0x3F e SQW/OUT pelo registrador de controle (0x07).
+#ifndef DS1307_MODEL_H
+#define DS1307_MODEL_H
+#include "i2c_dev.h"
+
+typedef struct {
+	i2c_dev_t dev;
+	uint8_t  reg[64];
+	uint8_t  ptr;
+	uint8_t  wr_first;       // prximo byte escrito  o ponteiro
+	uint32_t sec_start;      // incio do segundo corrente (sim_now_us)
+} ds1307_model_t;
+
+// Estado de fbrica: 01/01/2000 00:00:00, oscilador parado (CH = 1),
+// SQW desligado. Endereo 0x68, presente no barramento.
+void ds1307_model_init(ds1307_model_t *m);
+
+// Nvel do pino SQW/OUT agora (1 Hz: alto na primeira metade do segundo)
+uint8_t ds1307_model_sqw(ds1307_model_t *m);
+
+#endif
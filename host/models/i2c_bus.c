@@ -0,0 +1,25 @@
+#include "i2c_dev.h"
+#include <stddef.h>
+
+static i2c_dev_t *bus[I2C_BUS_MAX];
+
+void i2c_bus_reset(void) {
+	for (uint8_t i = 0; i < I2C_BUS_MAX; i++) bus[i] = NULL;
+}
+
+void i2c_bus_detach(uint8_t addr) {
+	for (uint8_t i = 0; i < I2C_BUS_MAX; i++)
+		if (bus[i] && bus[i]->addr == addr) bus[i] = NULL;
+}
+
+void i2c_bus_attach(i2c_dev_t *d) {
+	i2c_bus_detach(d->addr);
+	for (uint8_t i = 0; i < I2C_BUS_MAX; i++)
+		if (!bus[i]) { bus[i] = d; return; }
+}
+
+i2c_dev_t *i2c_bus_find(uint8_t addr) {
+	for (uint8_t i = 0; i < I2C_BUS_MAX; i++)
+		if (bus[i] && bus[i]->addr == addr && bus[i]->present) return bus[i];
+	return NULL;
+}
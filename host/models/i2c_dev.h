@@ -0,0 +1,27 @@
+// Interface dos modelos de escravos I2C no nvel de byte, usada pelo
+// backend do host (twi_master_host.c) e pela ponte TWI do simavr
+// (bench/bench.c)
+#ifndef I2C_DEV_H
+#define I2C_DEV_H
+#include <stdint.h>
+
+typedef struct i2c_dev {
+	uint8_t addr;                                       // 7 bits
+	uint8_t present;                                    // 0 = no responde ao endereo
+	void    (*start)(struct i2c_dev *d, uint8_t read);  // START/repeated START endereado
+	uint8_t (*write)(struct i2c_dev *d, uint8_t b);     // 1 = ACK
+	uint8_t (*read)(struct i2c_dev *d, uint8_t ack);    // ack = 0 no ltimo byte
+	void    (*stop)(struct i2c_dev *d);
+} i2c_dev_t;
+
+#define I2C_BUS_MAX 8
+
+// Coloca o modelo no barramento (substitui outro no mesmo endereo)
+void i2c_bus_attach(i2c_dev_t *d);
+void i2c_bus_detach(uint8_t addr);
+void i2c_bus_reset(void);
+
+// Escravo presente no endereo, ou NULL (NACK)
+i2c_dev_t *i2c_bus_find(uint8_t addr);
+
+#endif
@@ -0,0 +1,135 @@
+#include "lcd_model.h"
+#include "sim.h"
+#include <string.h>
+
+#define EXEC_US       37     // maioria das instrues e escrita de dado (fosc 270 kHz)
+#define EXEC_LONG_US  1520   // clear display, return home
+
+static lcd_model_t *self(i2c_dev_t *d) { return (lcd_model_t *)d; }
+
+static uint8_t busy(const lcd_model_t *m) {
+	return (int32_t)(sim_now_us() - m->busy_until) < 0;
+}
+
+static void instruction(lcd_model_t *m, uint8_t c) {
+	uint32_t exec = EXEC_US;
+	m->instr++;
+	if (c & 0x80) {                              // set DDRAM address
+		m->ac = c & 0x7F;
+	} else if (c & 0x40) {                       // set CGRAM address (no modelada)
+	} else if (c & 0x20) {                       // function set
+		m->four_bit = !(c & 0x10);
+		m->lines2 = !!(c & 0x08);
+	} else if (c & 0x10) {                       // cursor/display shift (no modelado)
+	} else if (c & 0x08) {                       // display on/off
+		m->display_on = !!(c & 0x04);
+	} else if (c & 0x04) {                       // entry mode
+		m->inc = !!(c & 0x02);
+	} else if (c & 0x02) {                       // return home
+		m->ac = 0;
+		exec = EXEC_LONG_US;
+	} else if (c & 0x01) {                       // clear display
+		memset(m->ddram, ' ', sizeof(m->ddram));
+		m->ac = 0;
+		m->inc = 1;
+		exec = EXEC_LONG_US;
+	}
+	m->busy_until = sim_now_us() + exec;
+}
+
+static void data_write(lcd_model_t *m, uint8_t v) {
+	m->data++;
+	m->ddram[m->ac & 0x7F] = v;
+	m->ac = (m->ac + (m->inc ? 1 : -1)) & 0x7F;
+	m->busy_until = sim_now_us() + EXEC_US;
+}
+
+// Descida de EN com RW = 0: captura D7..D4 (o nibble alto em 8 bits)
+static void latch(lcd_model_t *m, uint8_t rs, uint8_t nibble) {
+	uint8_t v;
+	if (!m->four_bit) {
+		v = nibble;                              // D3..D0 no ar: lidos como 0
+	} else if (m->phase == 0) {
+		m->hi = nibble;
+		m->phase = 1;
+		return;
+	} else {
+		v = m->hi | (nibble >> 4);
+		m->phase = 0;
+	}
+	if (busy(m)) m->busy_errors++;
+	if (rs) data_write(m, v);
+	else instruction(m, v);
+}
+
+// O que o HD44780 pe em D7..D4 com RW = 1 e EN alto
+static uint8_t drive(const lcd_model_t *m, uint8_t rs) {
+	uint8_t v = rs ? m->ddram[m->ac & 0x7F] : (uint8_t)((busy(m) ? 0x80 : 0) | (m->ac & 0x7F));
+	if (m->four_bit && m->phase) v <<= 4;
+	return v & 0xF0;
+}
+
+static uint8_t rw(const lcd_model_t *m, uint8_t pins) {
+	return m->rw_grounded ? 0 : (pins & LCD_MODEL_RW);
+}
+
+static void start(i2c_dev_t *d, uint8_t read) { (void)d; (void)read; }
+
+static uint8_t write(i2c_dev_t *d, uint8_t b) {
+	lcd_model_t *m = self(d);
+	uint8_t old = m->pins;
+	m->pins = b;
+	if (!m->written) {                           // sai do estado de power-on (tudo em 1)
+		m->written = 1;
+		return 1;
+	}
+
+	uint8_t ctl_changed = (rw(m, old) != rw(m, b)) || ((old ^ b) & LCD_MODEL_RS);
+	uint8_t en0 = old & LCD_MODEL_EN, en1 = b & LCD_MODEL_EN;
+
+	if (!en0 && en1) {                           // subida: RS/RW tm de estar estveis (tAS)
+		if (ctl_changed) m->timing_errors++;
+	} else if (en0 && !en1) {                    // descida: RS/RW e dados seguem (tAH/tH)
+		if (ctl_changed) m->timing_errors++;
+		if (rw(m, old)) {                        // fim de um nibble de leitura
+			m->bf_reads++;
+			if (m->four_bit) m->phase ^= 1;
+		} else {
+			latch(m, old & LCD_MODEL_RS, old & 0xF0);
+		}
+	} else if (en0 && en1 && ctl_changed) {      // RS/RW trocados com EN alto
+		m->timing_errors++;
+	}
+	return 1;
+}
+
+static uint8_t read(i2c_dev_t *d, uint8_t ack) {
+	lcd_model_t *m = self(d);
+	(void)ack;
+	uint8_t v = m->pins;                         // pull-up fraco onde o latch  1
+	if ((m->pins & LCD_MODEL_EN) && rw(m, m->pins))
+		v &= drive(m, m->pins & LCD_MODEL_RS) | 0x0F;
+	return v;
+}
+
+static void stop(i2c_dev_t *d) { (void)d; }
+
+void lcd_model_row(const lcd_model_t *m, uint8_t row, char *out) {
+	static const uint8_t offs[4] = { 0x00, 0x40, 0x14, 0x54 };
+	memcpy(out, &m->ddram[offs[row & 3]], 20);
+	out[20] = 0;
+}
+
+void lcd_model_init(lcd_model_t *m) {
+	memset(m, 0, sizeof(*m));
+	m->dev.addr = 0x27;
+	m->dev.present = 1;
+	m->dev.start = start;
+	m->dev.write = write;
+	m->dev.read = read;
+	m->dev.stop = stop;
+	m->pins = 0xFF;
+	m->inc = 1;
+	m->busy_until = sim_now_us();
+	memset(m->ddram, ' ', sizeof(m->ddram));
+}
@@ -0,0 +1,52 @@
+// Modelo do mdulo LCD I2C: PCF8574 (P0 = RS, P1 = RW, P2 = EN, P3 =
+// backlight, P4..P7 = D4..D7) ligado a um HD44780 (datasheet Hitachi
+// ADE-207-272). O PCF8574  quase-bidirecional: na leitura cada pino com
+// latch em 1 devolve o que o HD44780 estiver forando (seno o pull-up).
+//
+// O HD44780 liga em 8 bits; a sequncia de inicializao por instruo e
+// o function set de 4 bits so seguidos nibble a nibble. Dados/comandos
+// so capturados na descida de EN com RW = 0; com RW = 1 e EN alto ele pe
+// BF|AC (nibble alto, depois baixo) em D7..D4. Violaes de tempo que o
+// PCF8574 no consegue evitar, por trocar todos os pinos de uma vez, so
+// contadas: RS/RW mudando junto com EN (tAS na subida, tAH na descida) e
+// instrues escritas com o controlador ainda ocupado.
+#ifndef LCD_MODEL_H
+#define LCD_MODEL_H
+#include "i2c_dev.h"
+
+#define LCD_MODEL_RS   0x01
+#define LCD_MODEL_RW   0x02
+#define LCD_MODEL_EN   0x04
+#define LCD_MODEL_BL   0x08
+
+typedef struct {
+	i2c_dev_t dev;
+	uint8_t  rw_grounded;    // mdulo com R/W no GND: s escrita
+	uint8_t  pins;           // latch do PCF8574
+	uint8_t  written;        // 0 at a primeira escrita no PCF8574
+	// HD44780
+	uint8_t  four_bit;       // 1 depois do function set de 4 bits
+	uint8_t  phase;          // 4 bits: 0 = nibble alto, 1 = nibble baixo
+	uint8_t  hi;             // nibble alto recebido
+	uint8_t  ac;             // contador de endereo da DDRAM
+	uint8_t  ddram[128];
+	uint8_t  display_on;
+	uint8_t  lines2;         // function set N = 1
+	uint8_t  inc;            // entry mode I/D = 1
+	uint32_t busy_until;     // BF = 1 at aqui (sim_now_us)
+	// Contadores para os testes
+	uint16_t instr;          // instrues (RS = 0) executadas
+	uint16_t data;           // bytes de dados escritos na DDRAM
+	uint16_t bf_reads;       // nibbles lidos com RW = 1
+	uint16_t timing_errors;  // RS/RW trocados junto com a borda de EN
+	uint16_t busy_errors;    // escrita com BF = 1
+} lcd_model_t;
+
+// HD44780 recm-ligado (8 bits, display desligado), PCF8574 em 0x27 com
+// todos os pinos em 1
+void lcd_model_init(lcd_model_t *m);
+
+// Linha row (0..3) como aparece num display 20x4, terminada em '\0'
+void lcd_model_row(const lcd_model_t *m, uint8_t row, char *out);
+
+#endif
@@ -0,0 +1,11 @@
+#include "sim.h"
+
+static uint32_t now_us;
+
+uint32_t sim_now_us(void) {
+	return now_us;
+}
+
+void sim_advance_us(uint32_t us) {
+	now_us += us;
+}
@@ -0,0 +1,10 @@
+// Relgio simulado em microssegundos, comum ao backend do TWI, s esperas
+// dos drivers (_delay_ms/_delay_us) e aos modelos dos chips
+#ifndef HOST_SIM_H
+#define HOST_SIM_H
+#include <stdint.h>
+
+uint32_t sim_now_us(void);
+void sim_advance_us(uint32_t us);
+
+#endif
@@ -0,0 +1,35 @@
+#include "test.h"
+#include "twi_host.h"
+#include "i2c_dev.h"
+#include "bmp280.h"
+
+unsigned test_checks, test_failures;
+
+void test_bus_reset(void) {
+	i2c_bus_reset();
+	twi_init();
+	twi_host_log_reset();
+	twi_host_fail(0, TWI_OK, 0);
+	twi_stats_reset();
+}
+
+static void suite(const char *name, void (*fn)(void)) {
+	unsigned f = test_failures, c = test_checks;
+	fn();
+	printf("%-8s %4u verificacoes, %u falhas\n", name, test_checks - c, test_failures - f);
+}
+
+int main(void) {
+	printf("BMP280_ADDR = 0x%02X\n", BMP280_ADDR);
+	suite("bmp180", test_bmp180);
+	suite("kernel", test_bmp180_kernel);
+	suite("bmp280", test_bmp280);
+	suite("ds1307", test_ds1307);
+	suite("lcd", test_lcd);
+	suite("baro", test_baro);
+	suite("altitude", test_altitude);
+	suite("trend", test_trend);
+	printf("%s: %u verificacoes, %u falhas\n", test_failures ? "FALHOU" : "OK",
+	       test_checks, test_failures);
+	return test_failures != 0;
+}
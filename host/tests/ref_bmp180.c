@@ -0,0 +1,57 @@
+#include "ref_bmp180.h"
+
+// b5 (temperatura), b3 e b4 (presso) do datasheet
+static void terms(const int16_t *cal, uint16_t ut, uint8_t oss,
+                  int32_t *b5_out, int32_t *b3_out, uint32_t *b4_out) {
+	int32_t AC1 = cal[0], AC2 = cal[1], AC3 = cal[2];
+	uint32_t AC4 = (uint16_t)cal[3], AC5 = (uint16_t)cal[4], AC6 = (uint16_t)cal[5];
+	int32_t B1 = cal[6], B2 = cal[7], MC = cal[9], MD = cal[10];
+
+	int32_t x1 = ((int32_t)ut - (int32_t)AC6) * (int32_t)AC5 / 32768;
+	int32_t x2 = (MC * 2048) / (x1 + MD);
+	int32_t b5 = x1 + x2;
+
+	int32_t b6 = b5 - 4000;
+	x1 = (B2 * ((b6 * b6) >> 12)) >> 11;
+	x2 = (AC2 * b6) >> 11;
+	int32_t x3 = x1 + x2;
+	int32_t b3 = (((AC1 * 4 + x3) << oss) + 2) >> 2;
+
+	x1 = (AC3 * b6) >> 13;
+	x2 = (B1 * ((b6 * b6) >> 12)) >> 16;
+	x3 = ((x1 + x2) + 2) >> 2;
+	uint32_t b4 = (AC4 * (uint32_t)(x3 + 32768)) >> 15;
+	*b5_out = b5;
+	*b3_out = b3;
+	*b4_out = b4;
+}
+
+void ref_bmp180(const int16_t *cal, uint16_t ut, uint32_t up, uint8_t oss,
+                int16_t *t_centi, int32_t *p_pa) {
+	int32_t b5, b3, x1, x2;
+	uint32_t b4;
+	terms(cal, ut, oss, &b5, &b3, &b4);
+	uint32_t b7 = ((uint32_t)up - b3) * (50000 >> oss);
+
+	int32_t p;
+	if (b7 < 0x80000000)
+		p = (b7 << 1) / b4;
+	else
+		p = (b7 / b4) << 1;
+
+	x1 = (p >> 8) * (p >> 8);
+	x1 = (x1 * 3038) >> 16;
+	x2 = (-7357 * p) >> 16;
+	p = p + ((x1 + x2 + 3791) >> 4);
+
+	*t_centi = (int16_t)(((b5 + 8) >> 4) * 10);
+	*p_pa = p;
+}
+
+uint32_t ref_bmp180_up(const int16_t *cal, uint16_t ut, uint8_t oss, int32_t p_pa) {
+	int32_t b5, b3;
+	uint32_t b4;
+	terms(cal, ut, oss, &b5, &b3, &b4);
+	// p = 2 * (UP - b3) * (50000 >> oss) / b4
+	return (uint32_t)(b3 + (int32_t)((int64_t)p_pa * b4 / (2 * (50000 >> oss))));
+}
@@ -0,0 +1,17 @@
+// Compensao do BMP180 como no datasheet (seo 3.5), com as divises
+// inteiras comuns: referncia para conferir o kernel do driver
+#ifndef REF_BMP180_H
+#define REF_BMP180_H
+#include <stdint.h>
+
+// cal = AC1, AC2, AC3, AC4, AC5, AC6, B1, B2, MB, MC, MD
+// (AC4..AC6 so unsigned no sensor, passados aqui como os 16 bits crus)
+void ref_bmp180(const int16_t *cal, uint16_t ut, uint32_t up, uint8_t oss,
+                int16_t *t_centi, int32_t *p_pa);
+
+// UP que d p_pa antes da correo final (x1, x2, 3791), ou seja, a
+// presso compensada fica a alguns hPa de p_pa: gera UP plausvel para
+// qualquer calibrao
+uint32_t ref_bmp180_up(const int16_t *cal, uint16_t ut, uint8_t oss, int32_t p_pa);
+
+#endif
@@ -0,0 +1,41 @@
+// Mini framework dos testes do host: CHECK no aborta, s conta e mostra
+// a linha que falhou; main() devolve != 0 se algo falhou.
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+#include <stdio.h>
+#include <stdint.h>
+
+extern unsigned test_checks, test_failures;
+
+#define CHECK(cond) do {                                                  \
+	test_checks++;                                                        \
+	if (!(cond)) {                                                        \
+		test_failures++;                                                  \
+		printf("%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond);         \
+	}                                                                     \
+} while (0)
+
+#define CHECK_EQ(a, b) do {                                               \
+	long long va_ = (long long)(a), vb_ = (long long)(b);                 \
+	test_checks++;                                                        \
+	if (va_ != vb_) {                                                     \
+		test_failures++;                                                  \
+		printf("%s:%d: falhou: %s == %s (%lld != %lld)\n",                \
+		       __FILE__, __LINE__, #a, #b, va_, vb_);                     \
+	}                                                                     \
+} while (0)
+
+// Barramento vazio, TWI reiniciado, registro e contadores zerados
+void test_bus_reset(void);
+
+// Sutes (uma por driver)
+void test_bmp180(void);
+void test_bmp180_kernel(void);
+void test_bmp280(void);
+void test_ds1307(void);
+void test_lcd(void);
+void test_baro(void);
+void test_altitude(void);
+void test_trend(void);
+
+#endif
@@ -0,0 +1,41 @@
+#include "test.h"
+#include "altitude.h"
+#include <math.h>
+
+// Frmula baromtrica em double, em dm
+static double ref_dm(int32_t p, int32_t p_ref) {
+	return 443300.0 * (1.0 - pow((double)p / p_ref, 0.1903));
+}
+
+// Varredura do altitude.h: p_ref de 30000 a 120000 Pa e todo p com
+// p/p_ref em [0.625, 1.125]; erro at 2.1 dm e at 1.5 dm em [0.85, 1.125]
+static void error_bound_over_range(void) {
+	double worst = 0, worst_hi = 0;
+	uint32_t cases = 0;
+	for (int32_t p_ref = 30000; p_ref <= 120000; p_ref += 250) {
+		int32_t p_lo = (int32_t)ceil(p_ref * 0.625), p_hi = (int32_t)floor(p_ref * 1.125);
+		for (int32_t p = p_lo; p <= p_hi; p += 3) {
+			double e = fabs(altitude_dm(p, p_ref) - ref_dm(p, p_ref));
+			if (e > worst) worst = e;
+			if (p >= p_ref * 0.85 && e > worst_hi) worst_hi = e;
+			cases++;
+		}
+	}
+	CHECK(cases > 4000000);
+	CHECK(worst <= 2.1);
+	CHECK(worst_hi <= 1.5);
+}
+
+// Fora da faixa satura nos extremos da tabela; entradas invlidas do 0
+static void saturates_outside_range(void) {
+	CHECK_EQ(altitude_dm(50000, 101325), altitude_dm(63300, 101325));
+	CHECK_EQ(altitude_dm(120000, 101325), altitude_dm(114000, 101325));
+	CHECK_EQ(altitude_dm(101325, 101325), 0);
+	CHECK_EQ(altitude_dm(0, 101325), 0);
+	CHECK_EQ(altitude_dm(101325, 0), 0);
+}
+
+void test_altitude(void) {
+	error_bound_over_range();
+	saturates_outside_range();
+}
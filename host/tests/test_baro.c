@@ -0,0 +1,167 @@
+#include "test.h"
+#include "twi_host.h"
+#include "sim.h"
+#include "bmp180_model.h"
+#include "bmp280_model.h"
+#include "baro.h"
+#include "bmp180.h"
+#include "bmp280.h"
+
+static bmp180_model_t m180;
+static bmp280_model_t m280;
+
+// Deteco pelo chip ID e caminho nativo de cada sensor
+static void detects_chip(void) {
+	test_bus_reset();
+	bmp180_model_init(&m180);
+	i2c_bus_attach(&m180.dev);
+	CHECK_EQ(baro_init(), TWI_OK);
+	baro_set_oss(0);
+	int16_t t;
+	int32_t p;
+	CHECK_EQ(baro_read_raw(&t, &p), TWI_OK);
+	CHECK_EQ(p, 69964);
+	CHECK_EQ(m180.conversions, 2);
+
+	test_bus_reset();
+	bmp280_model_init(&m280);
+	m280.dev.addr = BMP280_ADDR;
+	i2c_bus_attach(&m280.dev);
+	CHECK_EQ(baro_init(), TWI_OK);
+	CHECK_EQ(baro_read_raw(&t, &p), TWI_OK);
+	CHECK_EQ(t, 2508);
+	CHECK_EQ(m280.measurements, 1);
+
+	test_bus_reset();
+	CHECK_EQ(baro_init(), TWI_NACK);             // nenhum sensor
+	CHECK_EQ(baro_read_raw(&t, &p), TWI_NACK);
+}
+
+// Segundo boot com o mesmo sensor: calibrao vem da EEPROM e s a
+// impresso digital (4 bytes)  lida; outro sensor invalida o cache
+static void calibration_cache(void) {
+	test_bus_reset();
+	bmp180_model_init(&m180);
+	i2c_bus_attach(&m180.dev);
+	baro_init();                                 // grava o cache do BMP180
+
+	twi_host_log_reset();
+	twi_stats_reset();
+	CHECK_EQ(baro_init(), TWI_OK);
+	CHECK(baro_from_cache());
+	uint32_t calib_bytes = 0;
+	for (uint16_t i = 0; i < twi_host_log_count(); i++)
+		calib_bytes += twi_host_log(i)->rlen;
+	CHECK_EQ(calib_bytes, 1 + 4);                // chip ID + impresso digital
+
+	// Mesmo modelo, outra calibrao: o cache no serve
+	int16_t cal[11] = { 500, -72, -14383, (int16_t)32741, (int16_t)32757, 23153,
+	                    6190, 4, -32768, -8711, 2868 };
+	bmp180_model_set_calib(&m180, cal);
+	CHECK_EQ(baro_init(), TWI_OK);
+	CHECK(!baro_from_cache());
+	CHECK_EQ(baro_init(), TWI_OK);
+	CHECK(baro_from_cache());
+}
+
+// Dormindo baro_wait_us() entre as etapas cada poll j acha a converso
+// pronta: BMP180 = comando, Sco, UT + comando, Sco, UP; BMP280 = comando,
+// status, dados
+static void wait_then_poll(void) {
+	int16_t t;
+	int32_t p;
+	test_bus_reset();
+	bmp180_model_init(&m180);
+	i2c_bus_attach(&m180.dev);
+	baro_init();
+	baro_set_oss(3);
+	twi_host_log_reset();
+	CHECK_EQ(baro_start(), TWI_OK);
+	CHECK_EQ(baro_wait_us(), 4500);
+	sim_advance_us(baro_wait_us());
+	CHECK(!baro_poll());                         // UT lido, presso disparada
+	CHECK_EQ(baro_wait_us(), 25500);
+	sim_advance_us(baro_wait_us());
+	CHECK(baro_poll());
+	CHECK_EQ(baro_wait_us(), 0);
+	CHECK_EQ(baro_read(&t, &p), TWI_OK);
+	CHECK_EQ(twi_host_log_count(), 6);
+
+	test_bus_reset();
+	bmp280_model_init(&m280);
+	m280.dev.addr = BMP280_ADDR;
+	i2c_bus_attach(&m280.dev);
+	baro_init();
+	twi_host_log_reset();
+	CHECK_EQ(baro_start(), TWI_OK);
+	CHECK(baro_wait_us() >= bmp280_model_meas_us(1, 1));
+	sim_advance_us(baro_wait_us());
+	CHECK(baro_poll());
+	CHECK_EQ(baro_read(&t, &p), TWI_OK);
+	CHECK_EQ(t, 2508);
+	CHECK_EQ(twi_host_log_count(), 3);
+}
+
+#if BMP280_ADDR != BMP180_ADDR
+// BMP280 em 0x76: ID, impresso digital e calibrao vo todos ao
+// endereo dele; 0x77 (BMP180) s leva o NACK da sondagem
+static void bmp280_at_its_address(void) {
+	test_bus_reset();
+	bmp280_model_init(&m280);
+	m280.dev.addr = BMP280_ADDR;
+	i2c_bus_attach(&m280.dev);
+	twi_host_log_reset();
+	CHECK_EQ(baro_init(), TWI_OK);
+	uint16_t at_280 = 0, at_180 = 0;
+	for (uint16_t i = 0; i < twi_host_log_count(); i++) {
+		const twi_log_t *l = twi_host_log(i);
+		if (l->addr == BMP280_ADDR) at_280++;
+		else if (l->addr == BMP180_ADDR && l->status == TWI_NACK) at_180++;
+	}
+	CHECK_EQ(at_180, 1);
+	CHECK_EQ(at_280 + at_180, twi_host_log_count());
+	CHECK(at_280 >= 2);                          // ID + calibrao (ou impresso digital)
+
+	int16_t t;
+	int32_t p;
+	CHECK_EQ(baro_read_raw(&t, &p), TWI_OK);
+	CHECK_EQ(t, 2508);
+	CHECK_EQ(baro_init(), TWI_OK);               // segundo boot: cache do mesmo sensor
+	CHECK(baro_from_cache());
+}
+#else
+// BMP280 no endereo padro, o mesmo do BMP180: a sondagem do BMP180 l
+// o ID 0x58 e passa adiante, e s a do BMP280 aceita. Todo o trfego vai
+// a 0x77 sem nenhum NACK.
+static void bmp280_at_its_address(void) {
+	test_bus_reset();
+	bmp280_model_init(&m280);
+	m280.dev.addr = BMP280_ADDR;
+	i2c_bus_attach(&m280.dev);
+	twi_host_log_reset();
+	CHECK_EQ(baro_init(), TWI_OK);
+	uint16_t id_reads = 0, bad = 0;
+	for (uint16_t i = 0; i < twi_host_log_count(); i++) {
+		const twi_log_t *l = twi_host_log(i);
+		if (l->addr != BMP280_ADDR || l->status != TWI_OK) bad++;
+		if (l->wlen == 1 && l->w[0] == BARO_REG_ID) id_reads++;
+	}
+	CHECK_EQ(bad, 0);
+	CHECK_EQ(id_reads, 2);                       // BMP180 (recusa) + BMP280
+
+	int16_t t;
+	int32_t p;
+	CHECK_EQ(baro_read_raw(&t, &p), TWI_OK);
+	CHECK_EQ(t, 2508);
+	CHECK_EQ(m280.measurements, 1);
+	CHECK_EQ(baro_init(), TWI_OK);
+	CHECK(baro_from_cache());
+}
+#endif
+
+void test_baro(void) {
+	detects_chip();
+	bmp280_at_its_address();
+	calibration_cache();
+	wait_then_poll();
+}
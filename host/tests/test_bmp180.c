@@ -0,0 +1,143 @@
+#include "test.h"
+#include "ref_bmp180.h"
+#include "twi_host.h"
+#include "sim.h"
+#include "bmp180_model.h"
+#include "bmp180.h"
+
+static bmp180_model_t m;
+
+static const int16_t ex_cal[11] = {
+	408, -72, -14383, (int16_t)32741, (int16_t)32757, 23153,
+	6190, 4, -32768, -8711, 2868
+};
+
+static void setup(void) {
+	test_bus_reset();
+	bmp180_model_init(&m);
+	i2c_bus_attach(&m.dev);
+}
+
+// Calibrao: uma transao, 22 bytes a partir de 0xAA, depois do start-up
+static void init_reads_calibration_in_one_burst(void) {
+	setup();
+	uint32_t t0 = sim_now_us();
+	CHECK_EQ(bmp180_init(), TWI_OK);
+	CHECK_EQ(twi_host_log_count(), 1);
+	const twi_log_t *l = twi_host_log(0);
+	CHECK_EQ(l->addr, BMP180_ADDR);
+	CHECK_EQ(l->wlen, 1);
+	CHECK_EQ(l->w[0], 0xAA);
+	CHECK_EQ(l->rlen, 22);
+	CHECK(l->at_us - t0 >= BMP180_STARTUP_MS * 1000UL);
+}
+
+// Exemplo do datasheet em OSS 0: 15.0 C e 69964 Pa, com o trfego
+// start temp -> Sco -> UT -> start presso -> Sco -> UP
+static void datasheet_example_oss0(void) {
+	setup();
+	bmp180_init();
+	bmp180_set_oss(0);
+	twi_host_log_reset();
+
+	int16_t t = 0;
+	int32_t p = 0;
+	uint32_t t0 = sim_now_us();
+	CHECK_EQ(bmp180_read_raw(&t, &p), TWI_OK);
+	uint32_t dt = sim_now_us() - t0;
+	CHECK_EQ(t, 1500);
+	CHECK_EQ(p, 69964);
+	CHECK_EQ(m.conversions, 2);
+
+	// Converses de 4.5 ms cada; o resto  o passo das consultas ao Sco
+	// (~1.3 ms cada) e as leituras, menos que o tempo das converses
+	CHECK(dt >= 9000 && dt < 18000);
+
+	uint16_t n = twi_host_log_count();
+	const twi_log_t *first = twi_host_log(0), *last = twi_host_log(n - 1);
+	CHECK_EQ(first->wlen, 2);
+	CHECK_EQ(first->w[0], 0xF4);
+	CHECK_EQ(first->w[1], 0x2E);
+	CHECK_EQ(last->w[0], 0xF6);
+	CHECK_EQ(last->rlen, 3);
+
+	uint8_t press_cmd = 0, ut_reads = 0;
+	for (uint16_t i = 0; i < n; i++) {
+		const twi_log_t *l = twi_host_log(i);
+		if (l->wlen == 2 && l->w[0] == 0xF4 && l->w[1] == 0x34) press_cmd++;
+		if (l->w[0] == 0xF6 && l->rlen == 2) ut_reads++;
+	}
+	CHECK_EQ(press_cmd, 1);
+	CHECK_EQ(ut_reads, 1);
+}
+
+// OSS 1..3: comando 0x34 + (oss << 6), espera maior e o mesmo resultado
+// da compensao do datasheet
+static void oversampling(void) {
+	for (uint8_t oss = 1; oss <= 3; oss++) {
+		setup();
+		bmp180_init();
+		bmp180_set_oss(oss);
+		twi_host_log_reset();
+
+		int16_t t, rt;
+		int32_t p, rp;
+		uint32_t t0 = sim_now_us();
+		CHECK_EQ(bmp180_read_raw(&t, &p), TWI_OK);
+		CHECK(sim_now_us() - t0 >= 4500UL + bmp180_conv_us(oss));
+
+		ref_bmp180(ex_cal, m.ut, m.up0 << oss, oss, &rt, &rp);
+		CHECK_EQ(t, rt);
+		CHECK_EQ(p, rp);
+
+		uint8_t found = 0;
+		for (uint16_t i = 0; i < twi_host_log_count(); i++) {
+			const twi_log_t *l = twi_host_log(i);
+			if (l->wlen == 2 && l->w[0] == 0xF4 && l->w[1] == (uint8_t)(0x34 + (oss << 6))) found++;
+		}
+		CHECK_EQ(found, 1);
+	}
+}
+
+// Sensor sumiu depois do init: status de erro e sada com o valor anterior
+static void absent_sensor_keeps_stale_values(void) {
+	setup();
+	bmp180_init();
+	i2c_bus_detach(BMP180_ADDR);
+
+	int16_t t = 1234;
+	int32_t p = 99999;
+	CHECK_EQ(bmp180_read_raw(&t, &p), TWI_NACK);
+	CHECK_EQ(t, 1234);
+	CHECK_EQ(p, 99999);
+
+	// Prazo estourado no meio da converso tambm no bloqueia
+	i2c_bus_attach(&m.dev);
+	CHECK_EQ(bmp180_start_temp(), TWI_OK);
+	twi_host_fail(BMP180_ADDR, TWI_TIMEOUT, 1);
+	CHECK(bmp180_poll());
+	CHECK_EQ(bmp180_result_raw(&t, &p), TWI_TIMEOUT);
+	CHECK_EQ(p, 99999);
+}
+
+// Sco preso em 1: desiste depois do limite de consultas
+static void stuck_sco_times_out(void) {
+	setup();
+	bmp180_init();
+	CHECK_EQ(bmp180_start_temp(), TWI_OK);
+	m.conv_end = sim_now_us() + 10000000UL;          // nunca termina no teste
+	uint16_t polls = 0;
+	while (!bmp180_poll()) polls++;
+	int16_t t;
+	int32_t p;
+	CHECK_EQ(bmp180_result_raw(&t, &p), TWI_TIMEOUT);
+	CHECK(polls > 0 && polls < 20);
+}
+
+void test_bmp180(void) {
+	init_reads_calibration_in_one_burst();
+	datasheet_example_oss0();
+	oversampling();
+	absent_sensor_keeps_stale_values();
+	stuck_sco_times_out();
+}
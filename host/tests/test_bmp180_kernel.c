@@ -0,0 +1,144 @@
+// Kernel do BMP180 por dentro: o .c do driver entra inteiro aqui para os
+// testes chegarem em recip_div/sdiv e no estado da converso (static).
+// Por isso o Makefile no compila bmp180.c  parte.
+#include "test.h"
+#include "ref_bmp180.h"
+#include "../../hPa_328P_v0_1_0/hPa_328P_v0_1_0/bmp180.c"
+
+// Gerador fixo: a mesma sequncia em toda rodada
+static uint32_t rng = 12345;
+static uint32_t rnd(void) {
+	rng = rng * 1664525UL + 1013904223UL;
+	return rng;
+}
+static int32_t rnd_in(int32_t lo, int32_t hi) {
+	return lo + (int32_t)(rnd() % (uint32_t)(hi - lo + 1));
+}
+
+// recip_div igual ao '/' para todo divisor da faixa, nos dividendos de
+// borda (0, d - 1, d, mltiplos de d e vizinhos, topo de 32 bits) e em
+// aleatrios; a estimativa nunca passa do quociente real e, depois da
+// segunda estimativa, falta no mximo uma correo
+static void recip_div_all_divisors(void) {
+	uint32_t wrong = 0, over = 0, fixes = 0, cases = 0;
+	for (uint32_t d = RECIP_MIN; d <= 0xFFFF; d++) {
+		recip_t q;
+		recip_set(&q, (uint16_t)d);
+		uint32_t n[24] = {
+			0, 1, d - 1, d, d + 1, 2 * d - 1, 2 * d,
+			0xFFFFFFFFUL, 0xFFFFFFFFUL - d, 0x7FFFFFFFUL, 0x80000000UL,
+			(0xFFFFFFFFUL / d) * d, (0xFFFFFFFFUL / d) * d - 1,
+		};
+		uint32_t k = rnd() % (0xFFFFFFFFUL / d);
+		n[13] = k * d;
+		n[14] = k * d + d - 1;
+		n[15] = k * d - 1;
+		for (uint8_t i = 16; i < 24; i++) n[i] = rnd();
+		for (uint8_t i = 0; i < 24; i++) {
+			cases++;
+			if (recip_div(&q, n[i]) != n[i] / d) wrong++;
+			uint32_t e = recip_est(&q, n[i]);
+			if (e > n[i] / d) over++;
+			uint32_t rem = n[i] - e * d;
+			rem -= recip_est(&q, rem) * d;
+			if (rem >= 2 * d) fixes++;
+		}
+	}
+	CHECK_EQ(cases, (0x10000UL - RECIP_MIN) * 24);
+	CHECK_EQ(wrong, 0);
+	CHECK_EQ(over, 0);
+	CHECK_EQ(fixes, 0);
+}
+
+// sdiv: sinais e divisores dentro e fora da faixa do recproco
+static void sdiv_matches_c_division(void) {
+	uint32_t wrong = 0;
+	for (uint32_t i = 0; i < 200000; i++) {
+		int32_t n = (int32_t)rnd();
+		int32_t d;
+		switch (i & 3) {
+		case 0:  d = rnd_in(RECIP_MIN, 0xFFFF); break;
+		case 1:  d = -rnd_in(RECIP_MIN, 0xFFFF); break;
+		case 2:  d = rnd_in(1, RECIP_MIN - 1); break;
+		default: d = rnd_in(0x10000, 0x7FFFFFFF); break;
+		}
+		if (n == INT32_MIN) n++;
+		if (sdiv(n, d) != n / d) wrong++;
+	}
+	CHECK_EQ(wrong, 0);
+}
+
+// Calibrao plausvel: faixas em volta dos valores de sensores reais
+static void random_calib(int16_t *cal, uint8_t *buf) {
+	cal[0]  = (int16_t)rnd_in(300, 10000);            // AC1
+	cal[1]  = (int16_t)rnd_in(-1500, 0);              // AC2
+	cal[2]  = (int16_t)rnd_in(-15000, -13000);        // AC3
+	cal[3]  = (int16_t)(uint16_t)rnd_in(30000, 35000);// AC4
+	cal[4]  = (int16_t)(uint16_t)rnd_in(24000, 33000);// AC5
+	cal[5]  = (int16_t)(uint16_t)rnd_in(18000, 24000);// AC6
+	cal[6]  = (int16_t)rnd_in(5000, 7000);            // B1
+	cal[7]  = (int16_t)rnd_in(0, 100);                // B2
+	cal[8]  = -32768;                                 // MB
+	cal[9]  = (int16_t)rnd_in(-12000, -8000);         // MC
+	cal[10] = (int16_t)rnd_in(2000, 3000);            // MD
+	for (uint8_t i = 0; i < 11; i++) {
+		buf[2 * i]     = (uint8_t)((uint16_t)cal[i] >> 8);
+		buf[2 * i + 1] = (uint8_t)cal[i];
+	}
+}
+
+// Compensao do driver contra a do datasheet: exemplo do datasheet e
+// calibraes aleatrias, os quatro OSS, UT e UP sorteados na faixa de
+// operao do sensor (o mesmo UT em seguida passa pelo cache dos termos
+// de temperatura)
+static void compensation_matches_datasheet(void) {
+	static const int16_t ex_cal[11] = {
+		408, -72, -14383, (int16_t)32741, (int16_t)32757, 23153,
+		6190, 4, -32768, -8711, 2868
+	};
+	uint32_t wrong = 0, cases = 0;
+	for (uint16_t c = 0; c < 400; c++) {
+		int16_t cal[11];
+		uint8_t buf[BMP180_CALIB_LEN];
+		random_calib(cal, buf);
+		if (c == 0) {
+			for (uint8_t i = 0; i < 11; i++) {
+				cal[i] = ex_cal[i];
+				buf[2 * i]     = (uint8_t)((uint16_t)cal[i] >> 8);
+				buf[2 * i + 1] = (uint8_t)cal[i];
+			}
+		}
+		if (bmp180_init_calib(buf) != TWI_OK) { wrong++; continue; }
+
+		for (uint8_t o = 0; o <= 3; o++) {
+			bmp180_set_oss(o);
+			for (uint8_t u = 0; u < 16; u++) {
+				// x1 de -40 a +85 C nos sensores reais; presso de 300 a 1100 hPa
+				uint16_t raw_t = (uint16_t)((uint16_t)cal[5] +
+				                 rnd_in(1500, 14000) * 32768L / (uint16_t)cal[4]);
+				for (uint8_t k = 0; k < 48; k++) {
+					uint32_t raw_p = ref_bmp180_up(cal, raw_t, o, rnd_in(30000, 110000));
+					int16_t t, rt;
+					int32_t p, rp;
+					ut = raw_t;
+					up = raw_p;
+					state = ST_READY;
+					last_st = TWI_OK;
+					cases++;
+					if (bmp180_result_raw(&t, &p) != TWI_OK) { wrong++; continue; }
+					ref_bmp180(cal, raw_t, raw_p, o, &rt, &rp);
+					if (t != rt || p != rp) wrong++;
+				}
+			}
+		}
+	}
+	CHECK_EQ(cases, 400UL * 4 * 16 * 48);
+	CHECK_EQ(wrong, 0);
+	bmp180_set_oss(BMP180_OSS_DEFAULT);
+}
+
+void test_bmp180_kernel(void) {
+	recip_div_all_divisors();
+	sdiv_matches_c_division();
+	compensation_matches_datasheet();
+}
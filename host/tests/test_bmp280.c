@@ -0,0 +1,131 @@
+#include "test.h"
+#include "twi_host.h"
+#include "sim.h"
+#include "bmp280_model.h"
+#include "bmp280.h"
+
+static bmp280_model_t m;
+
+static void setup(void) {
+	test_bus_reset();
+	bmp280_model_init(&m);
+	m.dev.addr = BMP280_ADDR;
+	i2c_bus_attach(&m.dev);
+}
+
+// Compensao em double do datasheet (seo 8.1), com a calibrao do modelo
+static void ref_bmp280(double *t_c, double *p_pa) {
+	const uint8_t *r = &m.reg[0x88];
+	#define U16(i) ((double)(uint16_t)(r[2 * (i)] | (r[2 * (i) + 1] << 8)))
+	#define S16(i) ((double)(int16_t)(r[2 * (i)] | (r[2 * (i) + 1] << 8)))
+	double T1 = U16(0), T2 = S16(1), T3 = S16(2);
+	double P1 = U16(3), P2 = S16(4), P3 = S16(5), P4 = S16(6), P5 = S16(7);
+	double P6 = S16(8), P7 = S16(9), P8 = S16(10), P9 = S16(11);
+	double at = m.adc_t, ap = m.adc_p;
+
+	double v1 = (at / 16384.0 - T1 / 1024.0) * T2;
+	double v2 = (at / 131072.0 - T1 / 8192.0) * (at / 131072.0 - T1 / 8192.0) * T3;
+	double t_fine = v1 + v2;
+	*t_c = t_fine / 5120.0;
+
+	v1 = t_fine / 2.0 - 64000.0;
+	v2 = v1 * v1 * P6 / 32768.0;
+	v2 = v2 + v1 * P5 * 2.0;
+	v2 = v2 / 4.0 + P4 * 65536.0;
+	v1 = (P3 * v1 * v1 / 524288.0 + P2 * v1) / 524288.0;
+	v1 = (1.0 + v1 / 32768.0) * P1;
+	double p = 1048576.0 - ap;
+	p = (p - v2 / 4096.0) * 6250.0 / v1;
+	v1 = P9 * p * p / 2147483648.0;
+	v2 = p * P8 / 32768.0;
+	*p_pa = p + (v1 + v2 + P7) / 16.0;
+	#undef U16
+	#undef S16
+}
+
+// Calibrao em um burst de 24 bytes; config e ctrl_meas (sleep) gravados
+static void init_traffic(void) {
+	setup();
+	CHECK_EQ(bmp280_init(), TWI_OK);
+	CHECK_EQ(twi_host_log_count(), 3);
+	const twi_log_t *l = twi_host_log(0);
+	CHECK_EQ(l->w[0], 0x88);
+	CHECK_EQ(l->rlen, 24);
+	l = twi_host_log(1);
+	CHECK_EQ(l->w[0], 0xF5);
+	CHECK_EQ(l->w[1], 0x00);
+	l = twi_host_log(2);
+	CHECK_EQ(l->w[0], 0xF4);
+	CHECK_EQ(l->w[1], 0x24);
+	CHECK_EQ(m.reg[0xF4] & 0x03, 0);
+}
+
+// Exemplo do datasheet: 25.08 C; presso a poucos Pa do double (a verso
+// de 32 bits trunca nos deslocamentos)
+static void datasheet_example(void) {
+	setup();
+	bmp280_init();
+	twi_host_log_reset();
+
+	int16_t t;
+	int32_t p;
+	uint32_t t0 = sim_now_us();
+	CHECK_EQ(bmp280_read_raw(&t, &p), TWI_OK);
+	CHECK(sim_now_us() - t0 >= bmp280_model_meas_us(1, 1));
+	CHECK_EQ(m.measurements, 1);
+	CHECK_EQ(m.reg[0xF4] & 0x03, 0);             // voltou a sleep
+
+	double rt, rp;
+	ref_bmp280(&rt, &rp);
+	CHECK_EQ(t, 2508);
+	CHECK(p - rp < 4.0 && rp - p < 4.0);    // 32 bits: 100656 contra 100653.27
+
+	// Disparo forado, consultas a 0xF3 (2 bytes) e um burst de 6 bytes
+	uint16_t n = twi_host_log_count();
+	const twi_log_t *l = twi_host_log(0);
+	CHECK_EQ(l->w[0], 0xF4);
+	CHECK_EQ(l->w[1], 0x25);
+	l = twi_host_log(n - 1);
+	CHECK_EQ(l->w[0], 0xF7);
+	CHECK_EQ(l->rlen, 6);
+	for (uint16_t i = 1; i < n - 1; i++) {
+		CHECK_EQ(twi_host_log(i)->w[0], 0xF3);
+		CHECK_EQ(twi_host_log(i)->rlen, 2);
+	}
+}
+
+// Erro no meio da medida: status repassado e valores anteriores mantidos
+static void bus_error_keeps_stale_values(void) {
+	setup();
+	bmp280_init();
+	int16_t t = 777;
+	int32_t p = 88888;
+	CHECK_EQ(bmp280_start(), TWI_OK);
+	twi_host_fail(BMP280_ADDR, TWI_NACK, 1);
+	CHECK(bmp280_poll());
+	CHECK_EQ(bmp280_result_raw(&t, &p), TWI_NACK);
+	CHECK_EQ(t, 777);
+	CHECK_EQ(p, 88888);
+}
+
+// Calibrao que zera o divisor da presso (dig_P1 = 1, dig_P2 = -32768,
+// dig_P3 = 0): erro prprio e valores anteriores mantidos, nada de 0 Pa
+static void degenerate_calibration_is_discarded(void) {
+	setup();
+	m.reg[0x8E] = 0x01; m.reg[0x8F] = 0x00;
+	m.reg[0x90] = 0x00; m.reg[0x91] = 0x80;
+	m.reg[0x92] = 0x00; m.reg[0x93] = 0x00;
+	CHECK_EQ(bmp280_init(), TWI_OK);
+	int16_t t = 777;
+	int32_t p = 88888;
+	CHECK_EQ(bmp280_read_raw(&t, &p), TWI_DATA_ERROR);
+	CHECK_EQ(t, 777);
+	CHECK_EQ(p, 88888);
+}
+
+void test_bmp280(void) {
+	init_traffic();
+	datasheet_example();
+	bus_error_keeps_stale_values();
+	degenerate_calibration_is_discarded();
+}
@@ -0,0 +1,94 @@
+#include "test.h"
+#include "twi_host.h"
+#include "sim.h"
+#include "ds1307_model.h"
+#include "ds1307.h"
+
+static ds1307_model_t m;
+
+static void setup(void) {
+	test_bus_reset();
+	ds1307_model_init(&m);
+	i2c_bus_attach(&m.dev);
+}
+
+static void wait_s(uint32_t s) {
+	while (s--) sim_advance_us(1000000UL);
+}
+
+// init: segundos com CH = 0 e SQW/OUT em 1 Hz
+static void init_starts_clock_and_sqw(void) {
+	setup();
+	CHECK_EQ(ds1307_init(), TWI_OK);
+	CHECK_EQ(twi_host_log_count(), 2);
+	CHECK_EQ(m.reg[0] & 0x80, 0);
+	CHECK_EQ(m.reg[7], DS1307_SQW_1HZ);
+
+	uint8_t hi = ds1307_model_sqw(&m);
+	sim_advance_us(500000UL);
+	CHECK(hi != ds1307_model_sqw(&m));
+}
+
+// Acerto, contagem e leitura em um burst de 7 bytes
+static void set_and_read_back(void) {
+	setup();
+	ds1307_init();
+	rtc_time t = { 58, 59, 23 };
+	rtc_date d = { 28, 2, 2024, 3 };
+	CHECK_EQ(ds1307_setTime(&t), TWI_OK);
+	CHECK_EQ(ds1307_setDate(&d), TWI_OK);
+	twi_host_log_reset();
+
+	wait_s(3);                                   // 23:59:58 + 3 s, 2024  bissexto
+	rtc_time rt;
+	rtc_date rd;
+	CHECK_EQ(ds1307_getDateTime(&rt, &rd), TWI_OK);
+	CHECK_EQ(rt.hour, 0);
+	CHECK_EQ(rt.min, 0);
+	CHECK_EQ(rt.sec, 1);
+	CHECK_EQ(rd.day, 29);
+	CHECK_EQ(rd.month, 2);
+	CHECK_EQ(rd.year, 2024);
+	CHECK_EQ(rd.weekday, 4);
+
+	CHECK_EQ(twi_host_log_count(), 1);
+	const twi_log_t *l = twi_host_log(0);
+	CHECK_EQ(l->addr, DS1307_ADDR);
+	CHECK_EQ(l->w[0], 0x00);
+	CHECK_EQ(l->rlen, 7);
+
+	wait_s(3600 + 61);
+	CHECK_EQ(ds1307_getTime(&rt), TWI_OK);
+	CHECK_EQ(rt.hour, 1);
+	CHECK_EQ(rt.min, 1);
+	CHECK_EQ(rt.sec, 2);
+	CHECK_EQ(ds1307_getDate(&rd), TWI_OK);
+	CHECK_EQ(rd.day, 29);
+}
+
+// Falha no barramento: status repassado, structs com a leitura anterior
+static void failure_keeps_last_reading(void) {
+	setup();
+	ds1307_init();
+	rtc_time t = { 10, 20, 12 };
+	ds1307_setTime(&t);
+
+	rtc_time rt = { 1, 2, 3 };
+	rtc_date rd = { 4, 5, 2006, 7 };
+	twi_host_fail(DS1307_ADDR, TWI_TIMEOUT, 1);
+	CHECK_EQ(ds1307_getDateTime(&rt, &rd), TWI_TIMEOUT);
+	CHECK_EQ(rt.sec, 1);
+	CHECK_EQ(rt.hour, 3);
+	CHECK_EQ(rd.year, 2006);
+	CHECK_EQ(twi_host_bus_clears > 0, 1);
+
+	i2c_bus_detach(DS1307_ADDR);
+	CHECK_EQ(ds1307_getTime(&rt), TWI_NACK);
+	CHECK_EQ(rt.min, 2);
+}
+
+void test_ds1307(void) {
+	init_starts_clock_and_sqw();
+	set_and_read_back();
+	failure_keeps_last_reading();
+}
@@ -0,0 +1,124 @@
+#include "test.h"
+#include "twi_host.h"
+#include "sim.h"
+#include "lcd_model.h"
+#include "lcd_i2c.h"
+#include <string.h>
+
+static lcd_model_t m;
+
+static void setup(uint8_t rw_grounded) {
+	test_bus_reset();
+	lcd_model_init(&m);
+	m.rw_grounded = rw_grounded;
+	i2c_bus_attach(&m.dev);
+	lcd_init();
+}
+
+static int row_is(uint8_t row, const char *text) {
+	char buf[21];
+	lcd_model_row(&m, row, buf);
+	return strcmp(buf, text) == 0;
+}
+
+// Sequncia de init: 4 bits, 2 linhas, display ligado, DDRAM limpa
+static void init_configures_controller(void) {
+	setup(0);
+	CHECK(m.four_bit);
+	CHECK(m.lines2);
+	CHECK(m.display_on);
+	CHECK(m.inc);
+	CHECK_EQ(m.ac, 0);
+	CHECK_EQ(m.busy_errors, 0);
+	CHECK_EQ(m.timing_errors, 0);
+	CHECK(m.bf_reads > 0);
+	CHECK(row_is(0, "                    "));
+}
+
+// Leitura do busy flag: RW sobe e desce com EN baixo, e o prximo
+// comando no troca RS/RW junto com a subida de EN
+static void busy_flag_timing(void) {
+	setup(0);
+	uint16_t reads = m.bf_reads;
+	lcd_clear();
+	lcd_print("x");
+	lcd_flush();
+	CHECK_EQ(m.timing_errors, 0);
+	CHECK_EQ(m.busy_errors, 0);
+	CHECK_EQ(m.bf_reads, reads);                 // flush no espera comandos
+	CHECK_EQ(m.pins & LCD_MODEL_RW, 0);
+	CHECK_EQ(m.pins & LCD_MODEL_EN, 0);
+}
+
+// O framebuffer s vai ao display no flush, e s o que mudou
+static void flush_sends_only_changes(void) {
+	setup(0);
+	lcd_clear();
+	lcd_set_cursor(0, 0);
+	lcd_print("T:");
+	lcd_put_fixed(235, 2, 1);
+	lcd_print("C");
+	lcd_set_cursor(0, 3);
+	lcd_print("Altitude: ");
+	lcd_put_fixed(-125, 4, 1);
+	lcd_print("m");
+	CHECK_EQ(m.data, 0);
+	lcd_flush();
+	CHECK(row_is(0, "T:23.5C             "));
+	CHECK(row_is(3, "Altitude:  -12.5m   "));
+	CHECK_EQ(m.busy_errors, 0);
+	CHECK_EQ(m.timing_errors, 0);
+
+	// Sem mudana: nenhuma transao
+	twi_host_log_reset();
+	lcd_flush();
+	CHECK_EQ(twi_host_log_count(), 0);
+
+	// Um caractere: Set DDRAM + dado numa transao de 8 bytes do PCF8574,
+	// mais um byte em cada troca de RS (dado -> comando -> dado)
+	lcd_set_cursor(3, 0);
+	lcd_print("4");
+	uint16_t data0 = m.data;
+	lcd_flush();
+	CHECK(row_is(0, "T:24.5C             "));
+	CHECK_EQ(m.data - data0, 1);
+	CHECK_EQ(twi_host_log_count(), 1);
+	CHECK_EQ(twi_host_log(0)->wlen, 10);
+	CHECK_EQ(m.timing_errors, 0);
+}
+
+// Nmeros sem float
+static void fixed_point_formatting(void) {
+	setup(0);
+	lcd_clear();
+	lcd_put_fixed(101325, 1, 2);
+	lcd_print("|");
+	lcd_put_u(7, 3);
+	lcd_print("|");
+	lcd_put_2d(5);
+	lcd_print("|");
+	lcd_put_fixed(-5, 1, 1);
+	lcd_flush();
+	CHECK(row_is(0, "1013.25|  7|05|-0.5 "));
+}
+
+// R/W no GND: o busy flag l 1 sempre e o driver volta aos atrasos fixos
+static void rw_grounded_module(void) {
+	setup(1);
+	CHECK(m.four_bit);
+	CHECK(m.display_on);
+	CHECK_EQ(m.bf_reads, 0);
+	lcd_clear();
+	lcd_print("Estacao ativa");
+	lcd_flush();
+	CHECK(row_is(0, "Estacao ativa       "));
+	CHECK_EQ(m.busy_errors, 0);
+}
+
+void test_lcd(void) {
+	init_configures_controller();
+	busy_flag_timing();
+	flush_sends_only_changes();
+	fixed_point_formatting();
+	rw_grounded_module();
+}
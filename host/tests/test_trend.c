@@ -0,0 +1,111 @@
+// Intervalo adaptativo do barmetro (trend.c) numa srie de 48 h amostrada
+// como o task_baro faz: 24 h estvel com 3 Pa rms de rudo, queda de
+// 1.5 hPa/h por 3 h e estvel de novo at o fim. O relgio de 16 bits do
+// sched_now() d a volta duas vezes no caminho. Com esta semente: 1813
+// converses (17280 a 10 s fixos), mximo em 170 s; na queda, intervalo
+// mnimo 630 s e seta 330 s depois do incio.
+#include "test.h"
+#include "trend.h"
+#include <math.h>
+
+#define MIN_S       10               // READ_INTERVAL_SECONDS do main.c (faixa normal)
+#define MAX_S       300              // BARO_MAX_INTERVAL_S do main.c
+#define NOISE_PA    3.0
+#define FALL_PA_H   150              // 1.5 hPa/h
+#define FALL_AT     (24 * 3600UL)
+#define FALL_S      (3 * 3600UL)
+#define RUN_S       (48 * 3600UL)
+
+// Gerador fixo: a mesma srie em toda rodada
+static uint32_t rng = 2024;
+static double rnd_unit(void) {
+	rng = rng * 1664525UL + 1013904223UL;
+	return ((rng >> 8) + 0.5) / 16777216.0;
+}
+static double gauss(void) {                  // Box-Muller
+	return sqrt(-2.0 * log(rnd_unit())) * cos(2.0 * M_PI * rnd_unit());
+}
+
+static double pressure(uint32_t t) {
+	double p = 101325.0;
+	if (t > FALL_AT + FALL_S) t = FALL_AT + FALL_S;
+	if (t > FALL_AT) p -= FALL_PA_H * (t - FALL_AT) / 3600.0;
+	return p;
+}
+
+static int arrow(void) {
+	int16_t s = trend_slope();
+	return s > TREND_ARROW_PA_H ? 1 : s < -TREND_ARROW_PA_H ? -1 : 0;
+}
+
+// Cada amostra: mede, alimenta o filtro e reprograma o perodo como o
+// sched_set_period (o novo perodo nunca adia o prazo j marcado)
+static void adaptive_interval_48h(void) {
+	uint32_t now = 0, next = MIN_S, samples = 0;
+	uint16_t period = MIN_S;
+	uint32_t reached_max = 0, detect_iv = 0, detect_arrow = 0, recovered = 0;
+	uint32_t flat_fast = 0, flat_arrows = 0, out_of_range = 0;
+	int32_t fall_slope_sum = 0, fall_slope_n = 0;
+
+	while (now < RUN_S) {
+		int32_t p = (int32_t)lround(pressure(now) + NOISE_PA * gauss());
+		trend_add(p, (uint16_t)now);
+		samples++;
+		uint16_t iv = trend_interval(MIN_S, MAX_S);
+		if (iv < MIN_S || iv > MAX_S) {          // fora da faixa (0: o tempo no andaria)
+			out_of_range++;
+			break;
+		}
+		if (now + iv < next) next = now + iv;
+		period = iv;
+
+		if (now < FALL_AT) {
+			if (!reached_max && iv == MAX_S) reached_max = now;
+			if (reached_max) {                   // estvel: longe dos limites
+				if (iv != MAX_S) flat_fast++;
+				if (arrow()) flat_arrows++;
+			}
+		} else if (now < FALL_AT + FALL_S) {
+			if (!detect_iv && iv == MIN_S) detect_iv = now - FALL_AT;
+			if (!detect_arrow && arrow() < 0) detect_arrow = now - FALL_AT;
+			if (now >= FALL_AT + FALL_S - 3600) {  // ltima hora: filtro j assentado
+				fall_slope_sum += trend_slope();
+				fall_slope_n++;
+			}
+		} else if (!recovered && iv == MAX_S && !arrow()) {
+			recovered = now - FALL_AT - FALL_S;
+		}
+
+		now = next;
+		next = now + period;
+	}
+
+	CHECK_EQ(out_of_range, 0);
+
+	// Estvel: o intervalo dobra at o mximo em poucos minutos e fica l
+	CHECK(reached_max > 0 && reached_max <= 15 * 60UL);
+	// Com 3 Pa rms um pico isolado de ~3 sigma (10 Pa) ainda move a
+	// inclinao uns 40 Pa/h a 300 s por amostra: a seta pode piscar numa
+	// amostra por dia, no mais
+	CHECK_EQ(flat_fast, 0);
+	CHECK(flat_arrows <= 2);
+
+	// Queda: volta ao mnimo e vira a seta dentro de ~20 min (o ltimo
+	// intervalo longo ainda corre quando a queda comea)
+	CHECK(detect_iv > 0 && detect_iv <= 20 * 60UL);
+	CHECK(detect_arrow > 0 && detect_arrow <= 20 * 60UL);
+	CHECK(fall_slope_n > 0);
+	int32_t fall_slope = fall_slope_n ? fall_slope_sum / fall_slope_n : 0;
+	CHECK(fall_slope <= -FALL_PA_H + 20 && fall_slope >= -FALL_PA_H - 20);
+
+	// Estvel de novo: a seta some e o intervalo volta ao mximo
+	CHECK(recovered > 0 && recovered <= 90 * 60UL);
+
+	// Bem menos converses que o intervalo fixo de 10 s (17280 em 48 h)
+	CHECK(samples < 3000);
+	CHECK(samples > RUN_S / MAX_S);
+}
+
+void test_trend(void) {
+	adaptive_interval_48h();
+}
@@ -0,0 +1,33 @@
+// Extras do backend simulado do TWI (twi_master_host.c) para os testes:
+// registro das transaes e injeo de falhas. A API normal do
+// twi_master.h  a mesma do firmware.
+#ifndef TWI_HOST_H
+#define TWI_HOST_H
+#include "twi_master.h"
+
+#define TWI_LOG_LEN    256   // transaes guardadas (as mais antigas saem)
+#define TWI_LOG_BYTES  32    // bytes guardados por fase
+
+typedef struct {
+	uint8_t addr;
+	uint8_t wlen, rlen;              // tamanhos pedidos
+	uint8_t w[TWI_LOG_BYTES];        // bytes escritos (at TWI_LOG_BYTES)
+	uint8_t r[TWI_LOG_BYTES];        // bytes lidos
+	twi_status_t status;
+	uint32_t at_us;                  // incio (sim_now_us)
+} twi_log_t;
+
+// Esquece as transaes registradas
+void twi_host_log_reset(void);
+// Transaes desde o ltimo reset
+uint16_t twi_host_log_count(void);
+// i-sima transao desde o reset (NULL se j saiu do registro)
+const twi_log_t *twi_host_log(uint16_t i);
+
+// As prximas n transaes para addr terminam em status sem chegar ao escravo
+void twi_host_fail(uint8_t addr, twi_status_t status, uint8_t n);
+
+// Vezes que twi_bus_clear() foi chamado
+extern uint16_t twi_host_bus_clears;
+
+#endif
@@ -0,0 +1,174 @@
+// Backend do twi_master.h para o host: cada transao vai direto aos
+// modelos do barramento (models/i2c_bus.c), byte a byte, e o relgio
+// simulado anda o tempo de cada byte no perfil de velocidade do escravo.
+// A contabilidade (TWI_STATS) segue as mesmas regras do motor do AVR.
+#include "twi_host.h"
+#include "i2c_dev.h"
+#include "sim.h"
+#include <string.h>
+
+static const uint16_t speed_us_byte[TWI_SPEED_COUNT] = {
+	TWI_US_BYTE(TWI_SCL_25K), TWI_US_BYTE(TWI_SCL_100K), TWI_US_BYTE(TWI_SCL_400K)
+};
+
+static uint8_t dev_addr[TWI_MAX_DEVICES];
+static uint8_t dev_speed[TWI_MAX_DEVICES];
+static uint8_t dev_count;
+
+static twi_log_t log_buf[TWI_LOG_LEN];
+static uint16_t log_count;
+
+static uint8_t fail_addr, fail_n;
+static twi_status_t fail_status;
+
+uint16_t twi_host_bus_clears;
+
+void twi_init(void) {
+	dev_count = 0;
+}
+
+uint8_t twi_set_speed(uint8_t addr, twi_speed_t speed) {
+	for (uint8_t i = 0; i < dev_count; i++) {
+		if (dev_addr[i] == addr) { dev_speed[i] = speed; return 1; }
+	}
+	if (dev_count == TWI_MAX_DEVICES) return 0;
+	dev_addr[dev_count] = addr;
+	dev_speed[dev_count++] = speed;
+	return 1;
+}
+
+static uint8_t speed_of(uint8_t addr) {
+	for (uint8_t i = 0; i < dev_count; i++)
+		if (dev_addr[i] == addr) return dev_speed[i];
+	return TWI_SPEED_25K;
+}
+
+void twi_bus_clear(void) {
+	twi_host_bus_clears++;
+	sim_advance_us(22UL * TWI_CLEAR_HALF_US);
+}
+
+// =============== Registro e falhas ===============
+void twi_host_log_reset(void) {
+	log_count = 0;
+}
+
+uint16_t twi_host_log_count(void) {
+	return log_count;
+}
+
+const twi_log_t *twi_host_log(uint16_t i) {
+	if (i >= log_count || log_count - i > TWI_LOG_LEN) return NULL;
+	return &log_buf[i % TWI_LOG_LEN];
+}
+
+void twi_host_fail(uint8_t addr, twi_status_t status, uint8_t n) {
+	fail_addr = addr;
+	fail_status = status;
+	fail_n = n;
+}
+
+// =============== Contabilidade ===============
+static twi_stats_t stats;
+
+void twi_stats_get(twi_stats_t *out) {
+	*out = stats;
+}
+
+void twi_stats_reset(void) {
+	memset(&stats, 0, sizeof(stats));
+}
+
+static void account(twi_xfer_t *x, twi_status_t status) {
+	uint16_t n = x->wlen + x->rlen + 1 + (x->wlen && x->rlen);
+	stats.xfers++;
+	if (status != TWI_OK) stats.errors++;
+	stats.bytes += n;
+	stats.bus_us += (uint32_t)n * speed_us_byte[x->speed];
+}
+
+// =============== Transao ===============
+// Um byte no barramento (endereo ou dado)
+static void byte_time(twi_xfer_t *x) {
+	sim_advance_us(speed_us_byte[x->speed]);
+}
+
+static twi_status_t run(twi_xfer_t *x) {
+	if (fail_n && x->addr == fail_addr) {
+		fail_n--;
+		if (fail_status == TWI_TIMEOUT) twi_bus_clear();
+		return fail_status;
+	}
+
+	i2c_dev_t *d = i2c_bus_find(x->addr);
+	byte_time(x);                                // SLA+W ou SLA+R
+	if (!d) return TWI_NACK;
+
+	if (x->wlen) {
+		d->start(d, 0);
+		for (uint8_t i = 0; i < x->wlen; i++) {
+			byte_time(x);
+			if (!d->write(d, x->wbuf[i])) { d->stop(d); return TWI_NACK; }
+		}
+		if (x->rlen) byte_time(x);               // repeated START + SLA+R
+	}
+	if (x->rlen) {
+		d->start(d, 1);
+		for (uint8_t i = 0; i < x->rlen; i++) {
+			byte_time(x);
+			x->rbuf[i] = d->read(d, i + 1 < x->rlen);
+		}
+	}
+	d->stop(d);
+	return TWI_OK;
+}
+
+static void record(twi_xfer_t *x, uint32_t at) {
+	twi_log_t *l = &log_buf[log_count++ % TWI_LOG_LEN];
+	l->addr = x->addr;
+	l->wlen = x->wlen;
+	l->rlen = x->rlen;
+	memset(l->w, 0, sizeof(l->w));
+	memset(l->r, 0, sizeof(l->r));
+	memcpy(l->w, x->wbuf, x->wlen < TWI_LOG_BYTES ? x->wlen : TWI_LOG_BYTES);
+	if (x->status == TWI_OK)
+		memcpy(l->r, x->rbuf, x->rlen < TWI_LOG_BYTES ? x->rlen : TWI_LOG_BYTES);
+	l->status = x->status;
+	l->at_us = at;
+}
+
+// Sem fila no host: a transao roda inteira dentro do submit
+uint8_t twi_submit(twi_xfer_t *x) {
+	uint32_t at = sim_now_us();
+	x->speed = speed_of(x->addr);
+	x->status = TWI_BUSY;
+	twi_status_t st = run(x);
+	account(x, st);
+	x->status = st;
+	record(x, at);
+	if (x->done) x->done(x);
+	return 1;
+}
+
+twi_status_t twi_wait(twi_xfer_t *x) {
+	return x->status;
+}
+
+twi_status_t twi_transfer(uint8_t addr, const uint8_t *wbuf, uint8_t wlen,
+                          uint8_t *rbuf, uint8_t rlen) {
+	twi_xfer_t x = { addr, wbuf, wlen, rbuf, rlen, 0, 0, 0, TWI_OK };
+	twi_submit(&x);
+	return twi_wait(&x);
+}
+
+twi_status_t twi_read_regs(uint8_t addr, uint8_t reg, uint8_t *buf, uint8_t n) {
+	return twi_transfer(addr, &reg, 1, buf, n);
+}
+
+twi_status_t twi_write_regs(uint8_t addr, uint8_t reg, const uint8_t *buf, uint8_t n) {
+	uint8_t b[1 + TWI_WRITE_REGS_MAX];
+	if (n > TWI_WRITE_REGS_MAX) return TWI_ARG_ERROR;
+	b[0] = reg;
+	for (uint8_t i = 0; i < n; i++) b[i + 1] = buf[i];
+	return twi_transfer(addr, b, n + 1, 0, 0);
+}